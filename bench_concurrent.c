@@ -0,0 +1,169 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <pthread.h>
+#include "priority_queue.h"
+#include "concurrent_priority_queue.h"
+#include "multi_queue.h"
+
+/**
+* Scaling benchmark of the concurrent priority queue.
+*
+* For every number of threads from 1 to N, each thread does the same number of operations
+* (an insertion of a random priority, then a pop), on a queue that was filled beforehand.
+* The throughput of a ConcurrentPriorityQueue and of a MultiQueue (with MULTI_QUEUE_SHARDS_PER_THREAD
+* shards per thread) is compared to a PriorityQueue behind one global mutex.
+*
+* usage: ./bench_concurrent [max_threads] [operations_per_thread] [initial_size]
+*/
+
+#define DEFAULT_MAX_THREADS 8
+#define DEFAULT_OPERATIONS 200000
+#define DEFAULT_INITIAL_SIZE 100000
+#define MULTI_QUEUE_SHARDS_PER_THREAD 2
+
+static PQElement copyInt(PQElement n) {
+    int *copy = malloc(sizeof(*copy));
+    if (copy != NULL) {
+        *copy = *(int *) n;
+    }
+    return copy;
+}
+
+static void freeInt(PQElement n) {
+    free(n);
+}
+
+static bool equalInts(PQElement n1, PQElement n2) {
+    return *(int *) n1 == *(int *) n2;
+}
+
+static int compareInts(PQElementPriority n1, PQElementPriority n2) {
+    return *(int *) n1 - *(int *) n2;
+}
+
+// the queue every thread works on: a concurrent queue, a multi queue, or a regular queue with its global mutex
+typedef struct {
+    ConcurrentPriorityQueue concurrent_queue;
+    MultiQueue multi_queue;
+    PriorityQueue locked_queue;
+    pthread_mutex_t lock;
+    int operations;
+} BenchQueue;
+
+typedef struct {
+    BenchQueue *bench_queue;
+    unsigned int seed;
+} BenchThread;
+
+// a simple per-thread random generator, so the threads don't share rand's state
+static int nextRandom(unsigned int *seed) {
+    *seed = *seed * 1103515245u + 12345u;
+    return (int) ((*seed >> 8) % 1000000u);
+}
+
+static void *runBenchThread(void *arguments) {
+    BenchThread *thread = arguments;
+    BenchQueue *queue = thread->bench_queue;
+    for (int i = 0; i < queue->operations; i++) {
+        int value = nextRandom(&thread->seed);
+        if (queue->concurrent_queue != NULL) {
+            cpqInsert(queue->concurrent_queue, &value, &value);
+            cpqPop(queue->concurrent_queue, NULL, NULL);
+        } else if (queue->multi_queue != NULL) {
+            mqInsert(queue->multi_queue, &value, &value);
+            mqPop(queue->multi_queue, NULL, NULL);
+        } else {
+            pthread_mutex_lock(&queue->lock);
+            pqInsert(queue->locked_queue, &value, &value);
+            pthread_mutex_unlock(&queue->lock);
+            pthread_mutex_lock(&queue->lock);
+            pqRemove(queue->locked_queue);
+            pthread_mutex_unlock(&queue->lock);
+        }
+    }
+    return NULL;
+}
+
+static double secondsSince(const struct timespec *start) {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double) (now.tv_sec - start->tv_sec) + (double) (now.tv_nsec - start->tv_nsec) / 1e9;
+}
+
+typedef enum { BENCH_CONCURRENT, BENCH_MULTI_QUEUE, BENCH_GLOBAL_MUTEX } BenchKind;
+
+// runs the benchmark with the given number of threads, and returns the operations per second
+static double runBench(BenchKind kind, int threads, int operations, int initial_size) {
+    BenchQueue queue = {NULL, NULL, NULL, PTHREAD_MUTEX_INITIALIZER, operations};
+    if (kind == BENCH_CONCURRENT) {
+        queue.concurrent_queue = cpqCreate(copyInt, freeInt, copyInt, freeInt, compareInts);
+    } else if (kind == BENCH_MULTI_QUEUE) {
+        queue.multi_queue = mqCreate(MULTI_QUEUE_SHARDS_PER_THREAD * threads, copyInt, freeInt, equalInts,
+                                     copyInt, freeInt, compareInts);
+    } else {
+        queue.locked_queue = pqCreate(copyInt, freeInt, equalInts, copyInt, freeInt, compareInts);
+    }
+    unsigned int seed = 1;
+    for (int i = 0; i < initial_size; i++) {
+        int value = nextRandom(&seed);
+        if (kind == BENCH_CONCURRENT) {
+            cpqInsert(queue.concurrent_queue, &value, &value);
+        } else if (kind == BENCH_MULTI_QUEUE) {
+            mqInsert(queue.multi_queue, &value, &value);
+        } else {
+            pqInsert(queue.locked_queue, &value, &value);
+        }
+    }
+
+    pthread_t *thread_ids = malloc(threads * sizeof(pthread_t));
+    BenchThread *thread_args = malloc(threads * sizeof(BenchThread));
+    if (thread_ids == NULL || thread_args == NULL) {
+        fprintf(stderr, "out of memory\n");
+        exit(1);
+    }
+    struct timespec start;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (int thread = 0; thread < threads; thread++) {
+        thread_args[thread].bench_queue = &queue;
+        thread_args[thread].seed = (unsigned int) thread + 2;
+        pthread_create(&thread_ids[thread], NULL, runBenchThread, &thread_args[thread]);
+    }
+    for (int thread = 0; thread < threads; thread++) {
+        pthread_join(thread_ids[thread], NULL);
+    }
+    double seconds = secondsSince(&start);
+
+    free(thread_ids);
+    free(thread_args);
+    cpqDestroy(queue.concurrent_queue);
+    mqDestroy(queue.multi_queue);
+    pqDestroy(queue.locked_queue);
+    pthread_mutex_destroy(&queue.lock);
+
+    // every operation is an insertion and a pop
+    return 2.0 * threads * operations / seconds;
+}
+
+int main(int argc, char *argv[]) {
+    int max_threads = argc > 1 ? atoi(argv[1]) : DEFAULT_MAX_THREADS;
+    int operations = argc > 2 ? atoi(argv[2]) : DEFAULT_OPERATIONS;
+    int initial_size = argc > 3 ? atoi(argv[3]) : DEFAULT_INITIAL_SIZE;
+    if (max_threads <= 0 || operations <= 0 || initial_size < 0) {
+        fprintf(stderr, "usage: %s [max_threads] [operations_per_thread] [initial_size]\n", argv[0]);
+        return 1;
+    }
+
+    printf("%8s %22s %22s %22s\n", "threads", "concurrent (ops/s)", "multi queue (ops/s)",
+           "global mutex (ops/s)");
+    for (int threads = 1; threads <= max_threads; threads++) {
+        double concurrent = runBench(BENCH_CONCURRENT, threads, operations, initial_size);
+        double multi_queue = runBench(BENCH_MULTI_QUEUE, threads, operations, initial_size);
+        double locked = runBench(BENCH_GLOBAL_MUTEX, threads, operations, initial_size);
+        printf("%8d %22.0f %22.0f %22.0f\n", threads, concurrent, multi_queue, locked);
+    }
+
+    return 0;
+}
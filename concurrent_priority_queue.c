@@ -0,0 +1,405 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "concurrent_priority_queue.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sched.h>
+
+/*----------------------------------------------------------------------
+                         Implementation constants
+ ----------------------------------------------------------------------*/
+
+// the heap is stored in levels: level k holds the 2^k nodes with indices 2^k to 2^(k+1) - 1 (the root is 1).
+// a level is allocated when the heap first reaches it, and never moves, so nodes can be locked without
+// locking the whole heap. MAX_LEVELS levels hold every index an int can have
+#define MAX_LEVELS 31
+
+// tags of a node: EMPTY if it holds no element, AVAILABLE if it holds an element in its place in the heap.
+// any other tag is the ticket of an insertion that is still moving its element up the heap
+#define EMPTY 0
+#define AVAILABLE 1
+#define FIRST_TICKET 2
+
+// a node of the heap
+typedef struct NodeStruct {
+    pthread_mutex_t lock;
+    unsigned long tag;
+    PQElement element;
+    PQElementPriority priority;
+    //insertion order of the element, used as the tie-breaker between equal priorities
+    unsigned long sequence;
+} Node;
+
+struct ConcurrentPriorityQueue_t {
+    //protects size, next_sequence and the allocation of levels
+    pthread_mutex_t heap_lock;
+
+    //number of elements in the queue (the nodes are filled in bit-reversed order, see nodeOfSize)
+    int size;
+
+    //sequence number given to the next inserted element, also used for the insertion tickets
+    unsigned long next_sequence;
+
+    //the levels of the heap, and the number of levels that were allocated
+    Node* levels[MAX_LEVELS];
+    int levels_allocated;
+
+    // function pointers that were defined in the header file
+    CopyPQElement copy_element;
+    FreePQElement free_element;
+    CopyPQElementPriority copy_priority;
+    FreePQElementPriority free_priority;
+    ComparePQElementPriorities compare_priorities;
+};
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// returns the level of the node with the given index (the index of its highest set bit)
+static int levelOf(int index) {
+    assert(index > 0);
+    int level = 0;
+    while(index >>= 1) {
+        level++;
+    }
+    return level;
+}
+
+// returns the node with the given index
+// NOTE: its level must have been allocated
+static Node* nodeAt(const ConcurrentPriorityQueue queue, int index) {
+    int level = levelOf(index);
+    return &queue->levels[level][index - (1 << level)];
+}
+
+// returns the index of the node that is filled when the queue reaches size (and emptied when it leaves it).
+// within a level the nodes are filled in bit-reversed order, so consecutive insertions go
+// into different subtrees, and their paths up the heap share as few nodes as possible
+static int nodeOfSize(int size) {
+    int level = levelOf(size);
+    int offset = size - (1 << level);
+    int reversed = 0;
+    for(int bit = 0; bit < level; bit++) {
+        reversed = (reversed << 1) | ((offset >> bit) & 1);
+    }
+    return (1 << level) | reversed;
+}
+
+// allocates the next level of the heap, with all of its nodes empty
+// NOTE: heap_lock must be held
+static bool addLevel(ConcurrentPriorityQueue queue) {
+    int level = queue->levels_allocated;
+    if(level == MAX_LEVELS) {
+        return false;
+    }
+    int level_size = 1 << level;
+    Node* nodes = malloc(level_size * sizeof(Node));
+    if(nodes == NULL) {
+        return false;
+    }
+    for(int node = 0; node < level_size; node++) {
+        if(pthread_mutex_init(&nodes[node].lock, NULL) != 0) {
+            while(--node >= 0) {
+                pthread_mutex_destroy(&nodes[node].lock);
+            }
+            free(nodes);
+            return false;
+        }
+        nodes[node].tag = EMPTY;
+    }
+    queue->levels[level] = nodes;
+    queue->levels_allocated++;
+    return true;
+}
+
+// returns true if the element in first should be removed before the element in second
+static bool nodeComesFirst(const ConcurrentPriorityQueue queue, const Node* first, const Node* second) {
+    int compare_result = queue->compare_priorities(first->priority, second->priority);
+    if(compare_result != 0) {
+        return compare_result > 0;
+    }
+    return first->sequence < second->sequence;
+}
+
+// swaps the contents (and tags) of two nodes
+// NOTE: both nodes must be locked
+static void swapNodes(Node* first, Node* second) {
+    unsigned long tag = first->tag;
+    PQElement element = first->element;
+    PQElementPriority priority = first->priority;
+    unsigned long sequence = first->sequence;
+    first->tag = second->tag;
+    first->element = second->element;
+    first->priority = second->priority;
+    first->sequence = second->sequence;
+    second->tag = tag;
+    second->element = element;
+    second->priority = priority;
+    second->sequence = sequence;
+}
+
+// moves an inserted element (tagged with ticket) up from the node with the given index to its place.
+// the element may be moved by removals meanwhile: it is then followed up the heap by its ticket
+static void moveUp(ConcurrentPriorityQueue queue, int index, unsigned long ticket) {
+    while(index > 1) {
+        int parent_index = index / 2;
+        Node* parent = nodeAt(queue, parent_index);
+        Node* current = nodeAt(queue, index);
+        pthread_mutex_lock(&parent->lock);
+        pthread_mutex_lock(&current->lock);
+
+        if(parent->tag == AVAILABLE && current->tag == ticket) {
+            // the parent is in its place: the element moves above it, or stops here
+            if(nodeComesFirst(queue, current, parent)) {
+                swapNodes(current, parent);
+                index = parent_index;
+            } else {
+                current->tag = AVAILABLE;
+                index = 0;
+            }
+        } else if(parent->tag == EMPTY) {
+            // a removal took the element up to the root (and emptied the path behind it)
+            index = 0;
+        } else if(current->tag != ticket) {
+            // a removal moved the element up, it is looked for in the parent
+            index = parent_index;
+        }
+        bool retry = index > 1 && current->tag == ticket && parent->tag != AVAILABLE && parent->tag != EMPTY;
+
+        pthread_mutex_unlock(&current->lock);
+        pthread_mutex_unlock(&parent->lock);
+
+        // otherwise the parent is still being inserted by another thread, which is let to make progress
+        // before the step is retried
+        if(retry) {
+            sched_yield();
+        }
+    }
+
+    if(index == 1) {
+        Node* root = nodeAt(queue, 1);
+        pthread_mutex_lock(&root->lock);
+        if(root->tag == ticket) {
+            root->tag = AVAILABLE;
+        }
+        pthread_mutex_unlock(&root->lock);
+    }
+}
+
+// moves the element at the root (which is locked) down to its place, unlocking the nodes behind it.
+// last_index is the largest index of an allocated node
+static void moveDown(ConcurrentPriorityQueue queue, int last_index) {
+    int index = 1;
+    Node* current = nodeAt(queue, 1);
+    while(2 * index <= last_index) {
+        int left_index = 2 * index;
+        Node* left = nodeAt(queue, left_index);
+        Node* right = left_index + 1 <= last_index ? nodeAt(queue, left_index + 1) : NULL;
+        pthread_mutex_lock(&left->lock);
+        if(right != NULL) {
+            pthread_mutex_lock(&right->lock);
+        }
+
+        // the child that comes first out of the (up to) two children
+        Node* child;
+        int child_index;
+        if(left->tag == EMPTY) {
+            if(right != NULL) {
+                pthread_mutex_unlock(&right->lock);
+            }
+            pthread_mutex_unlock(&left->lock);
+            break;
+        } else if(right == NULL || right->tag == EMPTY || nodeComesFirst(queue, left, right)) {
+            if(right != NULL) {
+                pthread_mutex_unlock(&right->lock);
+            }
+            child = left;
+            child_index = left_index;
+        } else {
+            pthread_mutex_unlock(&left->lock);
+            child = right;
+            child_index = left_index + 1;
+        }
+
+        if(!nodeComesFirst(queue, child, current)) {
+            pthread_mutex_unlock(&child->lock);
+            break;
+        }
+        swapNodes(child, current);
+        pthread_mutex_unlock(&current->lock);
+        current = child;
+        index = child_index;
+    }
+    pthread_mutex_unlock(&current->lock);
+}
+
+/*----------------------------------------------------------------------
+                   Concurrent priority queue functions
+ ----------------------------------------------------------------------*/
+
+ConcurrentPriorityQueue cpqCreate(CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities) {
+    // check for NULL parameters
+    if(copy_element == NULL || free_element == NULL || copy_priority == NULL || free_priority == NULL ||
+       compare_priorities == NULL) {
+        return NULL;
+    }
+
+    ConcurrentPriorityQueue queue = malloc(sizeof(*queue));
+    if(queue == NULL) {
+        return NULL;
+    }
+    if(pthread_mutex_init(&queue->heap_lock, NULL) != 0) {
+        free(queue);
+        return NULL;
+    }
+
+    queue->size = 0;
+    queue->next_sequence = 0;
+    queue->levels_allocated = 0;
+
+    // use the funcs given by the user
+    queue->copy_element = copy_element;
+    queue->free_element = free_element;
+    queue->copy_priority = copy_priority;
+    queue->free_priority = free_priority;
+    queue->compare_priorities = compare_priorities;
+
+    return queue;
+}
+
+void cpqDestroy(ConcurrentPriorityQueue queue) {
+    if(queue == NULL) {
+        return;
+    }
+
+    // frees the elements in the nodes, then the nodes themselves
+    for(int level = 0; level < queue->levels_allocated; level++) {
+        for(int node = 0; node < (1 << level); node++) {
+            Node* current = &queue->levels[level][node];
+            if(current->tag != EMPTY) {
+                queue->free_element(current->element);
+                queue->free_priority(current->priority);
+            }
+            pthread_mutex_destroy(&current->lock);
+        }
+        free(queue->levels[level]);
+    }
+    pthread_mutex_destroy(&queue->heap_lock);
+    free(queue);
+}
+
+int cpqGetSize(ConcurrentPriorityQueue queue) {
+    if(queue == NULL) {
+        return -1;
+    }
+    pthread_mutex_lock(&queue->heap_lock);
+    int size = queue->size;
+    pthread_mutex_unlock(&queue->heap_lock);
+    return size;
+}
+
+PriorityQueueResult cpqInsert(ConcurrentPriorityQueue queue, PQElement element, PQElementPriority priority) {
+    if(queue == NULL || element == NULL || priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // copies the inputted element and priority before taking any lock
+    PQElement new_element = queue->copy_element(element);
+    if(new_element == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    PQElementPriority new_priority = queue->copy_priority(priority);
+    if(new_priority == NULL) {
+        queue->free_element(new_element);
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // takes the next node (allocating its level if needed) while holding the heap lock,
+    // and then only the node's lock
+    pthread_mutex_lock(&queue->heap_lock);
+    if(queue->size == (1 << queue->levels_allocated) - 1 && !addLevel(queue)) {
+        pthread_mutex_unlock(&queue->heap_lock);
+        queue->free_element(new_element);
+        queue->free_priority(new_priority);
+        return PQ_OUT_OF_MEMORY;
+    }
+    int index = nodeOfSize(++queue->size);
+    unsigned long sequence = queue->next_sequence++;
+    Node* node = nodeAt(queue, index);
+    pthread_mutex_lock(&node->lock);
+    pthread_mutex_unlock(&queue->heap_lock);
+
+    // the ticket marks the element as still moving up
+    unsigned long ticket = sequence + FIRST_TICKET;
+    node->element = new_element;
+    node->priority = new_priority;
+    node->sequence = sequence;
+    node->tag = ticket;
+    pthread_mutex_unlock(&node->lock);
+
+    moveUp(queue, index, ticket);
+
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult cpqPop(ConcurrentPriorityQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // takes the last node out of the heap while holding the heap lock, and then only the node's lock
+    pthread_mutex_lock(&queue->heap_lock);
+    if(queue->size == 0) {
+        pthread_mutex_unlock(&queue->heap_lock);
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+    int last_index = (1 << queue->levels_allocated) - 1;
+    Node* bottom = nodeAt(queue, nodeOfSize(queue->size--));
+    pthread_mutex_lock(&bottom->lock);
+    pthread_mutex_unlock(&queue->heap_lock);
+
+    PQElement moved_element = bottom->element;
+    PQElementPriority moved_priority = bottom->priority;
+    unsigned long moved_sequence = bottom->sequence;
+    bottom->tag = EMPTY;
+    pthread_mutex_unlock(&bottom->lock);
+
+    // the last element takes the root's place (unless the last node was the root),
+    // and is then moved down to restore the heap
+    Node* root = nodeAt(queue, 1);
+    pthread_mutex_lock(&root->lock);
+    PQElement removed_element = moved_element;
+    PQElementPriority removed_priority = moved_priority;
+    if(root->tag != EMPTY) {
+        removed_element = root->element;
+        removed_priority = root->priority;
+        root->element = moved_element;
+        root->priority = moved_priority;
+        root->sequence = moved_sequence;
+        root->tag = AVAILABLE;
+        moveDown(queue, last_index);
+    } else {
+        pthread_mutex_unlock(&root->lock);
+    }
+
+    // the caller gets what it asked for, and the rest is freed
+    if(element != NULL) {
+        *element = removed_element;
+    } else {
+        queue->free_element(removed_element);
+    }
+    if(priority != NULL) {
+        *priority = removed_priority;
+    } else {
+        queue->free_priority(removed_priority);
+    }
+
+    return PQ_SUCCESS;
+}
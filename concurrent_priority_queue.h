@@ -0,0 +1,105 @@
+#ifndef CONCURRENT_PRIORITY_QUEUE_H
+#define CONCURRENT_PRIORITY_QUEUE_H
+
+#include "priority_queue.h"
+
+/**
+* Concurrent Priority Queue Container
+*
+* Implements a thread-safe priority queue, that many threads can insert into and pop from in parallel.
+* It uses the same element and priority function types as the priority queue in priority_queue.h,
+* and removes elements in the same order: the highest priority first, and equal priorities by
+* insertion order (when the queue isn't changed concurrently).
+*
+* The queue is a heap with a lock per node (Hunt et al., "An Efficient Algorithm for Concurrent
+* Priority Queue Heaps"): an insertion only locks the nodes on its way up the heap, and a removal
+* the nodes on its way down, so operations on different parts of the heap don't wait for each other.
+* Consecutive insertions go to different subtrees of the heap, to keep their paths apart.
+*
+* The following functions are available:
+*   cpqCreate		    - Creates a new empty concurrent priority queue
+*   cpqDestroy		    - Deletes an existing concurrent priority queue and frees all resources
+*   cpqGetSize		    - Returns the size of a given concurrent priority queue
+*   cpqInsert		    - Insert an element with a given priority to the queue. Thread-safe.
+*   cpqPop		        - Removes the highest priority element in the queue and hands it to the caller.
+*                           Thread-safe.
+*/
+
+/** Type for defining the concurrent priority queue */
+typedef struct ConcurrentPriorityQueue_t *ConcurrentPriorityQueue;
+
+/**
+* cpqCreate: Allocates a new empty concurrent priority queue.
+*
+* @param copy_element - Function pointer to be used for copying data elements into
+*  	the priority queue or when copying the priority queue.
+* @param free_element - Function pointer to be used for removing data elements from
+* 		the priority queue
+* @param copy_priority - Function pointer to be used for copying priority into
+*  	the priority queue or when copying the priority queue.
+* @param free_priority - Function pointer to be used for removing priority from
+* 		the priority queue
+* @param compare_priorities - Function pointer to be used for comparing priority of elements.
+* 		Called by many threads at once, so it must be thread-safe (as must the other functions).
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new concurrent priority queue in case of success.
+*/
+ConcurrentPriorityQueue cpqCreate(CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities);
+
+/**
+* cpqDestroy: Deallocates an existing concurrent priority queue. Clears all elements by using the
+* free functions.
+* Not thread-safe: no other thread may use the queue during or after this operation.
+*
+* @param queue - Target concurrent priority queue to be deallocated. If it is NULL nothing will be done
+*/
+void cpqDestroy(ConcurrentPriorityQueue queue);
+
+/**
+* cpqGetSize: Returns the number of elements in a concurrent priority queue.
+* While other threads change the queue, the size may already be different when it is returned.
+* @param queue - The concurrent priority queue which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the priority queue.
+*/
+int cpqGetSize(ConcurrentPriorityQueue queue);
+
+/**
+*   cpqInsert: add a specified element with a specific priority. Thread-safe.
+*
+* @param queue - The concurrent priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The new priority to associate with the given element.
+*      A copy of the element will be inserted as supplied by the copying function
+*      which is given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_OUT_OF_MEMORY if an allocation failed (Meaning the function for copying
+* 	an element failed)
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult cpqInsert(ConcurrentPriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/**
+*   cpqPop: Removes the highest priority element from the concurrent priority queue, and hands it to
+*   the caller, like pqPop. Thread-safe.
+*
+* @param queue - The concurrent priority queue to remove the element from.
+* @param element - Set to the removed element, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @param priority - Set to the priority of the removed element, which the caller is responsible for freeing.
+* 		If NULL, the priority is freed using the free function given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_SUCCESS the most prioritized element had been removed successfully.
+*/
+PriorityQueueResult cpqPop(ConcurrentPriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+#endif /* CONCURRENT_PRIORITY_QUEUE_H */
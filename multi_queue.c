@@ -0,0 +1,321 @@
+#define _POSIX_C_SOURCE 200112L
+
+#include "multi_queue.h"
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+/*----------------------------------------------------------------------
+                         Implementation constants
+ ----------------------------------------------------------------------*/
+
+// a shard of the multi queue: a regular priority queue behind its own lock
+typedef struct ShardStruct {
+    pthread_mutex_t lock;
+    PriorityQueue queue;
+} Shard;
+
+struct MultiQueue_t {
+    Shard* shards;
+    int shard_count;
+
+    //per-thread state of the random generator that picks the shards (the value itself, not a pointer)
+    pthread_key_t random_state;
+
+    //whether pops track their rank error. read and written atomically, so untracked pops only lock
+    //the shards they pick
+    bool track_rank;
+
+    //protects the rank statistics below
+    pthread_mutex_t statistics_lock;
+    long measured_pops;
+    long total_rank_error;
+    long max_rank_error;
+
+    ComparePQElementPriorities compare_priorities;
+};
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// returns a random shard index, using a xorshift generator whose state is kept per thread,
+// so threads don't share (and contend on) the generator
+static int randomShard(MultiQueue queue) {
+    uintptr_t state = (uintptr_t) pthread_getspecific(queue->random_state);
+    if(state == 0) {
+        // seeded by the address of a local variable, which is different for every thread's stack
+        int local;
+        state = (uintptr_t) &local | 1;
+    }
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    if(state == 0) {
+        state = 1;
+    }
+    pthread_setspecific(queue->random_state, (void*) state);
+    return (int) ((state >> 8) % (uintptr_t) queue->shard_count);
+}
+
+// picks two different random shards (one if there is only one shard), in index order
+static void pickTwoShards(MultiQueue queue, int* first, int* second) {
+    *first = randomShard(queue);
+    *second = *first;
+    if(queue->shard_count > 1) {
+        *second = randomShard(queue) % (queue->shard_count - 1);
+        if(*second >= *first) {
+            (*second)++;
+        }
+    }
+    if(*second < *first) {
+        int temp = *first;
+        *first = *second;
+        *second = temp;
+    }
+}
+
+// returns the index of the shard whose top element should be popped out of first and second,
+// or -1 if both are empty
+// NOTE: the locks of both shards must be held
+static int betterShard(MultiQueue queue, int first, int second) {
+    PQElementPriority first_priority = NULL;
+    PQElementPriority second_priority = NULL;
+    pqPeek(queue->shards[first].queue, NULL, &first_priority);
+    pqPeek(queue->shards[second].queue, NULL, &second_priority);
+    if(first_priority == NULL) {
+        return second_priority == NULL ? -1 : second;
+    }
+    if(second_priority == NULL || queue->compare_priorities(first_priority, second_priority) >= 0) {
+        return first;
+    }
+    return second;
+}
+
+// pops the top element of the given shard, measuring its rank error over all of the shards
+// NOTE: the locks of all shards must be held
+static PriorityQueueResult popAndMeasure(MultiQueue queue, int shard,
+                                         PQElement* element, PQElementPriority* priority) {
+    PQElementPriority popped_priority = NULL;
+    pqPeek(queue->shards[shard].queue, NULL, &popped_priority);
+    long rank_error = 0;
+    for(int i = 0; i < queue->shard_count; i++) {
+        int higher = pqCountHigherPriority(queue->shards[i].queue, popped_priority);
+        if(higher > 0) {
+            rank_error += higher;
+        }
+    }
+
+    pthread_mutex_lock(&queue->statistics_lock);
+    if(__atomic_load_n(&queue->track_rank, __ATOMIC_ACQUIRE)) {
+        queue->measured_pops++;
+        queue->total_rank_error += rank_error;
+        if(rank_error > queue->max_rank_error) {
+            queue->max_rank_error = rank_error;
+        }
+    }
+    pthread_mutex_unlock(&queue->statistics_lock);
+
+    return pqPop(queue->shards[shard].queue, element, priority);
+}
+
+// pops with rank tracking: all of the shards are locked (in index order), so the rank error is exact
+static PriorityQueueResult popTracked(MultiQueue queue, PQElement* element, PQElementPriority* priority) {
+    for(int i = 0; i < queue->shard_count; i++) {
+        pthread_mutex_lock(&queue->shards[i].lock);
+    }
+    int first, second;
+    pickTwoShards(queue, &first, &second);
+    int shard = betterShard(queue, first, second);
+    for(int i = 0; shard == -1 && i < queue->shard_count; i++) {
+        if(pqGetSize(queue->shards[i].queue) > 0) {
+            shard = i;
+        }
+    }
+    PriorityQueueResult result = PQ_ITEM_DOES_NOT_EXIST;
+    if(shard != -1) {
+        result = popAndMeasure(queue, shard, element, priority);
+    }
+    for(int i = queue->shard_count - 1; i >= 0; i--) {
+        pthread_mutex_unlock(&queue->shards[i].lock);
+    }
+    return result;
+}
+
+/*----------------------------------------------------------------------
+                        Multi queue functions
+ ----------------------------------------------------------------------*/
+
+MultiQueue mqCreate(int shard_count,
+                    CopyPQElement copy_element,
+                    FreePQElement free_element,
+                    EqualPQElements equal_elements,
+                    CopyPQElementPriority copy_priority,
+                    FreePQElementPriority free_priority,
+                    ComparePQElementPriorities compare_priorities) {
+    // check for NULL parameters (the shards check the rest)
+    if(shard_count <= 0 || compare_priorities == NULL) {
+        return NULL;
+    }
+
+    MultiQueue queue = malloc(sizeof(*queue));
+    if(queue == NULL) {
+        return NULL;
+    }
+    queue->shards = malloc(shard_count * sizeof(Shard));
+    if(queue->shards == NULL) {
+        free(queue);
+        return NULL;
+    }
+    if(pthread_key_create(&queue->random_state, NULL) != 0) {
+        free(queue->shards);
+        free(queue);
+        return NULL;
+    }
+    if(pthread_mutex_init(&queue->statistics_lock, NULL) != 0) {
+        pthread_key_delete(queue->random_state);
+        free(queue->shards);
+        free(queue);
+        return NULL;
+    }
+
+    queue->shard_count = 0;
+    queue->track_rank = false;
+    queue->measured_pops = 0;
+    queue->total_rank_error = 0;
+    queue->max_rank_error = 0;
+    queue->compare_priorities = compare_priorities;
+
+    // creates the shards one by one, so a failure only destroys the ones that were created
+    for(int i = 0; i < shard_count; i++) {
+        Shard* shard = &queue->shards[i];
+        shard->queue = pqCreate(copy_element, free_element, equal_elements,
+                                copy_priority, free_priority, compare_priorities);
+        if(shard->queue == NULL) {
+            mqDestroy(queue);
+            return NULL;
+        }
+        if(pthread_mutex_init(&shard->lock, NULL) != 0) {
+            pqDestroy(shard->queue);
+            mqDestroy(queue);
+            return NULL;
+        }
+        queue->shard_count++;
+    }
+
+    return queue;
+}
+
+void mqDestroy(MultiQueue queue) {
+    if(queue == NULL) {
+        return;
+    }
+
+    for(int i = 0; i < queue->shard_count; i++) {
+        pqDestroy(queue->shards[i].queue);
+        pthread_mutex_destroy(&queue->shards[i].lock);
+    }
+    pthread_mutex_destroy(&queue->statistics_lock);
+    pthread_key_delete(queue->random_state);
+    free(queue->shards);
+    free(queue);
+}
+
+int mqGetSize(MultiQueue queue) {
+    if(queue == NULL) {
+        return -1;
+    }
+
+    int size = 0;
+    for(int i = 0; i < queue->shard_count; i++) {
+        pthread_mutex_lock(&queue->shards[i].lock);
+        size += pqGetSize(queue->shards[i].queue);
+        pthread_mutex_unlock(&queue->shards[i].lock);
+    }
+    return size;
+}
+
+PriorityQueueResult mqInsert(MultiQueue queue, PQElement element, PQElementPriority priority) {
+    if(queue == NULL || element == NULL || priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    Shard* shard = &queue->shards[randomShard(queue)];
+    pthread_mutex_lock(&shard->lock);
+    PriorityQueueResult result = pqInsert(shard->queue, element, priority);
+    pthread_mutex_unlock(&shard->lock);
+    return result;
+}
+
+PriorityQueueResult mqPop(MultiQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    if(__atomic_load_n(&queue->track_rank, __ATOMIC_ACQUIRE)) {
+        return popTracked(queue, element, priority);
+    }
+
+    // locks the two shards in index order, so two pops can't wait for each other
+    int first, second;
+    pickTwoShards(queue, &first, &second);
+    pthread_mutex_lock(&queue->shards[first].lock);
+    if(second != first) {
+        pthread_mutex_lock(&queue->shards[second].lock);
+    }
+    int shard = betterShard(queue, first, second);
+    PriorityQueueResult result = PQ_ITEM_DOES_NOT_EXIST;
+    if(shard != -1) {
+        result = pqPop(queue->shards[shard].queue, element, priority);
+    }
+    if(second != first) {
+        pthread_mutex_unlock(&queue->shards[second].lock);
+    }
+    pthread_mutex_unlock(&queue->shards[first].lock);
+    if(shard != -1) {
+        return result;
+    }
+
+    // both shards were empty: the queue is only empty if all of its shards are
+    for(int i = 0; i < queue->shard_count; i++) {
+        pthread_mutex_lock(&queue->shards[i].lock);
+        result = pqPop(queue->shards[i].queue, element, priority);
+        pthread_mutex_unlock(&queue->shards[i].lock);
+        if(result != PQ_ITEM_DOES_NOT_EXIST) {
+            return result;
+        }
+    }
+    return PQ_ITEM_DOES_NOT_EXIST;
+}
+
+PriorityQueueResult mqSetRankTracking(MultiQueue queue, bool track) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&queue->statistics_lock);
+    // the lock keeps the counters from being reset while a tracked pop adds to them
+    if(track && !__atomic_load_n(&queue->track_rank, __ATOMIC_ACQUIRE)) {
+        queue->measured_pops = 0;
+        queue->total_rank_error = 0;
+        queue->max_rank_error = 0;
+    }
+    __atomic_store_n(&queue->track_rank, track, __ATOMIC_RELEASE);
+    pthread_mutex_unlock(&queue->statistics_lock);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult mqGetRankStatistics(MultiQueue queue, MQRankStatistics* statistics) {
+    if(queue == NULL || statistics == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    pthread_mutex_lock(&queue->statistics_lock);
+    statistics->pops = queue->measured_pops;
+    statistics->mean_rank_error = queue->measured_pops == 0 ? 0.0 :
+                                  (double) queue->total_rank_error / (double) queue->measured_pops;
+    statistics->max_rank_error = queue->max_rank_error;
+    pthread_mutex_unlock(&queue->statistics_lock);
+    return PQ_SUCCESS;
+}
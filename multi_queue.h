@@ -0,0 +1,149 @@
+#ifndef MULTI_QUEUE_H
+#define MULTI_QUEUE_H
+
+#include "priority_queue.h"
+
+/**
+* Relaxed MultiQueue Container
+*
+* Implements a thread-safe priority queue with relaxed ordering, that scales with the number of threads.
+* It uses the same element and priority function types as the priority queue in priority_queue.h.
+*
+* The queue is made of several independent priority queues (shards), each behind its own lock
+* (Rihani, Sanders and Dementiev, "MultiQueues: Simple Relaxed Concurrent Priority Queues").
+* An insertion goes to a random shard, and a pop looks at the tops of two random shards and removes
+* the one with the higher priority. Threads rarely wait for each other, but a pop doesn't always
+* return the highest priority element of the whole queue: it returns one of the highest priorities,
+* and the rank error (the number of elements with a higher priority than the removed one) stays small
+* on average. With c * P shards for P threads (c = 2 to 4 is typical), the shards are rarely contended.
+* The rank error can be measured with mqSetRankTracking and mqGetRankStatistics.
+*
+* Equal priorities are not removed by insertion order across shards.
+*
+* The following functions are available:
+*   mqCreate		        - Creates a new empty multi queue
+*   mqDestroy		        - Deletes an existing multi queue and frees all resources
+*   mqGetSize		        - Returns the size of a given multi queue
+*   mqInsert		        - Insert an element with a given priority to a random shard. Thread-safe.
+*   mqPop		            - Removes a high priority element and hands it to the caller. Thread-safe.
+*   mqSetRankTracking	    - Turns the measurement of the rank error of pops on or off
+*   mqGetRankStatistics	    - Returns the rank error of the measured pops
+*/
+
+/** Type for defining the multi queue */
+typedef struct MultiQueue_t *MultiQueue;
+
+/** The rank error of the pops measured by a multi queue (see mqSetRankTracking) */
+typedef struct MQRankStatistics_t {
+    // number of pops that were measured
+    long pops;
+    // average and largest number of elements that had a higher priority than a popped element
+    double mean_rank_error;
+    long max_rank_error;
+} MQRankStatistics;
+
+/**
+* mqCreate: Allocates a new empty multi queue.
+*
+* @param shard_count - Number of shards (priority queues) to use. Should be a few times the number of
+*       threads that use the queue. With one shard, the queue is exact but doesn't scale.
+* @param copy_element - Function pointer to be used for copying data elements into
+*  	the multi queue.
+* @param free_element - Function pointer to be used for removing data elements from
+* 		the multi queue
+* @param equal_elements - Function pointer to be used for comparing elements
+* @param copy_priority - Function pointer to be used for copying priority into
+*  	the multi queue.
+* @param free_priority - Function pointer to be used for removing priority from
+* 		the multi queue
+* @param compare_priorities - Function pointer to be used for comparing priority of elements.
+* 		Called by many threads at once, so it must be thread-safe (as must the other functions).
+* @return
+* 	NULL - if one of the parameters is NULL, shard_count isn't positive or allocations failed.
+* 	A new multi queue in case of success.
+*/
+MultiQueue mqCreate(int shard_count,
+                    CopyPQElement copy_element,
+                    FreePQElement free_element,
+                    EqualPQElements equal_elements,
+                    CopyPQElementPriority copy_priority,
+                    FreePQElementPriority free_priority,
+                    ComparePQElementPriorities compare_priorities);
+
+/**
+* mqDestroy: Deallocates an existing multi queue. Clears all elements by using the free functions.
+* Not thread-safe: no other thread may use the queue during or after this operation.
+*
+* @param queue - Target multi queue to be deallocated. If it is NULL nothing will be done
+*/
+void mqDestroy(MultiQueue queue);
+
+/**
+* mqGetSize: Returns the number of elements in a multi queue.
+* While other threads change the queue, the size may already be different when it is returned.
+* @param queue - The multi queue which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the multi queue.
+*/
+int mqGetSize(MultiQueue queue);
+
+/**
+*   mqInsert: add a specified element with a specific priority to a random shard. Thread-safe.
+*
+* @param queue - The multi queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The new priority to associate with the given element.
+*      A copy of the element will be inserted as supplied by the copying function
+*      which is given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_OUT_OF_MEMORY if an allocation failed (Meaning the function for copying
+* 	an element failed)
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult mqInsert(MultiQueue queue, PQElement element, PQElementPriority priority);
+
+/**
+*   mqPop: Removes the higher priority of the top elements of two random shards, and hands it to the
+*   caller, like pqPop. If both shards are empty, the other shards are searched, so the queue is only
+*   reported empty when all of its shards are. Thread-safe.
+*
+* @param queue - The multi queue to remove the element from.
+* @param element - Set to the removed element, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @param priority - Set to the priority of the removed element, which the caller is responsible for freeing.
+* 		If NULL, the priority is freed using the free function given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the multi queue is empty.
+* 	PQ_SUCCESS an element had been removed successfully.
+*/
+PriorityQueueResult mqPop(MultiQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   mqSetRankTracking: Turns the measurement of the rank error of pops on or off.
+*   While it is on, every pop locks all of the shards to count the elements with a higher priority
+*   than the removed one, so it is meant for testing the quality of the queue, not for production.
+*   Turning it on resets the statistics.
+*
+* @param queue - The multi queue to measure.
+* @param track - true to measure the pops from now on, false to stop.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult mqSetRankTracking(MultiQueue queue, bool track);
+
+/**
+*   mqGetRankStatistics: Returns the rank error of the pops measured since rank tracking was turned on.
+*
+* @param queue - The multi queue to get the statistics of.
+* @param statistics - Set to the statistics of the measured pops (all zero if none were measured).
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult mqGetRankStatistics(MultiQueue queue, MQRankStatistics* statistics);
+
+#endif /* MULTI_QUEUE_H */
@@ -0,0 +1,349 @@
+#include "pairing_heap.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+// a node of the heap: an element with its priority, in the tree.
+// the children of a node are a list linked through next and previous, and the first child's
+// previous is its parent (so a node can be cut out of the tree in O(1))
+struct PHNode_t {
+    PQElement element;
+    PQElementPriority priority;
+    //the value of next_sequence in the heap when the element was inserted (or its priority changed)
+    unsigned long sequence;
+
+    //the first child of the node, and the siblings before and after it (the parent for a first child)
+    struct PHNode_t* child;
+    struct PHNode_t* previous;
+    struct PHNode_t* next;
+};
+
+struct PairingHeap_t {
+    //the root of the tree, the element that comes first. NULL if the heap is empty
+    PHNode root;
+
+    //number of elements in the heap
+    int size;
+
+    //sequence number given to the next inserted element
+    unsigned long next_sequence;
+
+    // function pointers that were defined in the header file
+    CopyPQElement copy_element;
+    FreePQElement free_element;
+    CopyPQElementPriority copy_priority;
+    FreePQElementPriority free_priority;
+    ComparePQElementPriorities compare_priorities;
+};
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// returns true if the first node should leave the heap before the second one.
+// the higher priority comes first, and between two equal priorities the one inserted first
+static bool nodeComesFirst(const PairingHeap heap, const PHNode first, const PHNode second) {
+    int compare_result = heap->compare_priorities(first->priority, second->priority);
+    if(compare_result != 0) {
+        return compare_result > 0;
+    }
+    return first->sequence < second->sequence;
+}
+
+// links the trees of two roots into one, by making the one that comes later the first child of the other.
+// returns the root of the linked tree
+static PHNode linkTrees(const PairingHeap heap, PHNode first, PHNode second) {
+    if(nodeComesFirst(heap, second, first)) {
+        PHNode temp = first;
+        first = second;
+        second = temp;
+    }
+    second->previous = first;
+    second->next = first->child;
+    if(first->child != NULL) {
+        first->child->previous = second;
+    }
+    first->child = second;
+    first->previous = NULL;
+    first->next = NULL;
+    return first;
+}
+
+// links a list of sibling trees (the children of a removed node) into one tree, and returns its root.
+// the trees are linked in pairs from left to right, and then the pairs from right to left
+// (the two-pass pairing that makes the amortized bounds hold). returns NULL for an empty list
+static PHNode linkSiblings(const PairingHeap heap, PHNode first) {
+    if(first == NULL) {
+        return NULL;
+    }
+
+    // the first pass keeps the linked pairs in a list through next, the last pair first
+    PHNode pairs = NULL;
+    while(first != NULL) {
+        PHNode linked = first;
+        PHNode second = first->next;
+        if(second != NULL) {
+            first = second->next;
+            linked = linkTrees(heap, linked, second);
+        } else {
+            first = NULL;
+        }
+        linked->next = pairs;
+        pairs = linked;
+    }
+
+    // the second pass links every pair into the tree of the pairs after it
+    PHNode root = pairs;
+    pairs = pairs->next;
+    while(pairs != NULL) {
+        PHNode next = pairs->next;
+        root = linkTrees(heap, root, pairs);
+        pairs = next;
+    }
+    root->previous = NULL;
+    root->next = NULL;
+    return root;
+}
+
+// takes a node that isn't the root (with its subtree) out of the list of its siblings
+static void cutNode(PHNode node) {
+    assert(node->previous != NULL);
+    if(node->previous->child == node) {
+        node->previous->child = node->next;
+    } else {
+        node->previous->next = node->next;
+    }
+    if(node->next != NULL) {
+        node->next->previous = node->previous;
+    }
+    node->previous = NULL;
+    node->next = NULL;
+}
+
+// adds the tree of a node to the heap
+static void addTree(PairingHeap heap, PHNode node) {
+    heap->root = heap->root == NULL ? node : linkTrees(heap, heap->root, node);
+}
+
+// frees the element and priority of a node, and the node itself
+static void freeNode(const PairingHeap heap, PHNode node) {
+    heap->free_element(node->element);
+    heap->free_priority(node->priority);
+    free(node);
+}
+
+/*----------------------------------------------------------------------
+                        Pairing heap functions
+ ----------------------------------------------------------------------*/
+
+PairingHeap phCreate(CopyPQElement copy_element,
+                     FreePQElement free_element,
+                     CopyPQElementPriority copy_priority,
+                     FreePQElementPriority free_priority,
+                     ComparePQElementPriorities compare_priorities) {
+    // check for NULL parameters
+    if(copy_element == NULL || free_element == NULL || copy_priority == NULL || free_priority == NULL ||
+       compare_priorities == NULL) {
+        return NULL;
+    }
+
+    PairingHeap heap = malloc(sizeof(*heap));
+    if(heap == NULL) {
+        return NULL;
+    }
+    heap->root = NULL;
+    heap->size = 0;
+    heap->next_sequence = 0;
+
+    // use the funcs given by the user
+    heap->copy_element = copy_element;
+    heap->free_element = free_element;
+    heap->copy_priority = copy_priority;
+    heap->free_priority = free_priority;
+    heap->compare_priorities = compare_priorities;
+
+    return heap;
+}
+
+void phDestroy(PairingHeap heap) {
+    if(heap == NULL) {
+        return;
+    }
+
+    phClear(heap);
+    free(heap);
+}
+
+int phGetSize(PairingHeap heap) {
+    if(heap == NULL) {
+        return -1;
+    }
+    return heap->size;
+}
+
+PriorityQueueResult phInsert(PairingHeap heap, PQElement element, PQElementPriority priority, PHNode* node) {
+    if(heap == NULL || element == NULL || priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    PHNode new_node = malloc(sizeof(*new_node));
+    if(new_node == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    new_node->element = heap->copy_element(element);
+    if(new_node->element == NULL) {
+        free(new_node);
+        return PQ_OUT_OF_MEMORY;
+    }
+    new_node->priority = heap->copy_priority(priority);
+    if(new_node->priority == NULL) {
+        heap->free_element(new_node->element);
+        free(new_node);
+        return PQ_OUT_OF_MEMORY;
+    }
+    new_node->sequence = heap->next_sequence++;
+    new_node->child = NULL;
+    new_node->previous = NULL;
+    new_node->next = NULL;
+
+    // the new node is a tree of its own, linked with the root
+    addTree(heap, new_node);
+    heap->size++;
+
+    if(node != NULL) {
+        *node = new_node;
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult phPeek(PairingHeap heap, PQElement* element, PQElementPriority* priority) {
+    if(heap == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(heap->root == NULL) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    if(element != NULL) {
+        *element = heap->root->element;
+    }
+    if(priority != NULL) {
+        *priority = heap->root->priority;
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult phPop(PairingHeap heap, PQElement* element, PQElementPriority* priority) {
+    if(heap == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(heap->root == NULL) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    // the children of the root become the new tree
+    PHNode removed = heap->root;
+    heap->root = linkSiblings(heap, removed->child);
+    heap->size--;
+
+    // the caller gets what it asked for, and the rest is freed
+    if(element != NULL) {
+        *element = removed->element;
+    } else {
+        heap->free_element(removed->element);
+    }
+    if(priority != NULL) {
+        *priority = removed->priority;
+    } else {
+        heap->free_priority(removed->priority);
+    }
+    free(removed);
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult phChangePriority(PairingHeap heap, PHNode node, PQElementPriority new_priority) {
+    if(heap == NULL || node == NULL || new_priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    PQElementPriority new_priority_copy = heap->copy_priority(new_priority);
+    if(new_priority_copy == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    bool raised = heap->compare_priorities(new_priority_copy, node->priority) > 0;
+    heap->free_priority(node->priority);
+    node->priority = new_priority_copy;
+    node->sequence = heap->next_sequence++;
+
+    // the node's subtree is cut out of the tree. a raised node still comes before all of its subtree,
+    // otherwise its children are linked into a tree of their own first
+    if(node == heap->root) {
+        heap->root = NULL;
+    } else {
+        cutNode(node);
+    }
+    if(!raised) {
+        PHNode children = linkSiblings(heap, node->child);
+        node->child = NULL;
+        if(children != NULL) {
+            node = linkTrees(heap, node, children);
+        }
+    }
+    addTree(heap, node);
+
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult phMeld(PairingHeap destination, PairingHeap source) {
+    if(destination == NULL || source == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // the nodes of source are freed and compared by destination from now on
+    if(destination == source || destination->free_element != source->free_element ||
+       destination->free_priority != source->free_priority ||
+       destination->compare_priorities != source->compare_priorities) {
+        return PQ_ERROR;
+    }
+
+    if(source->root != NULL) {
+        addTree(destination, source->root);
+    }
+    destination->size += source->size;
+
+    // elements inserted from now on come after all the elements of both heaps
+    if(source->next_sequence > destination->next_sequence) {
+        destination->next_sequence = source->next_sequence;
+    }
+    source->root = NULL;
+    source->size = 0;
+
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult phClear(PairingHeap heap) {
+    if(heap == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // walks the tree without recursion (it may be as deep as its size): the children of every freed node
+    // are put in front of the list of the nodes that are left
+    PHNode pending = heap->root;
+    while(pending != NULL) {
+        PHNode node = pending;
+        pending = node->next;
+        if(node->child != NULL) {
+            PHNode last_child = node->child;
+            while(last_child->next != NULL) {
+                last_child = last_child->next;
+            }
+            last_child->next = pending;
+            pending = node->child;
+        }
+        freeNode(heap, node);
+    }
+    heap->root = NULL;
+    heap->size = 0;
+
+    return PQ_SUCCESS;
+}
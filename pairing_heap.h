@@ -0,0 +1,163 @@
+#ifndef PAIRING_HEAP_H
+#define PAIRING_HEAP_H
+
+#include "priority_queue.h"
+
+/**
+* Pairing Heap Container
+*
+* Implements a priority queue that can meld (merge) two heaps in O(1), for users that combine many queues
+* (such as per-thread queues that are combined at the end of every epoch). The element with the highest
+* priority is removed first, like in priority_queue.h, and it uses the same function types.
+*
+* The heap is a tree in which no node comes before its parent (Fredman, Sedgewick, Sleator and Tarjan,
+* "The Pairing Heap: A New Form of Self-Adjusting Heap"). Inserting and melding only link two trees, so they
+* take O(1) time. Popping links the children of the root in pairs, and then the pairs into one tree,
+* which takes amortized O(log n) time. Raising the priority of an element cuts it out of the tree and links
+* it back, in amortized o(log n) time.
+* Every node is allocated on its own (rather than from a pool of the heap), so a melded heap can take
+* the nodes of the other heap as they are.
+*
+* Equal priorities of a heap are removed by insertion order. After two heaps are melded, equal priorities
+* that came from different heaps are removed in an unspecified order.
+*
+* The following functions are available:
+*   phCreate		    - Creates a new empty pairing heap
+*   phDestroy		    - Deletes an existing pairing heap and frees all resources
+*   phGetSize		    - Returns the size of a given pairing heap
+*   phInsert		    - Insert an element with a given priority to the pairing heap, in O(1)
+*   phPeek		        - Returns the highest priority element (and its priority) without removing it
+*   phPop		        - Removes the highest priority element and hands it to the caller
+*   phChangePriority	- Changes the priority of an element, given its handle
+*   phMeld		        - Moves all the elements of one pairing heap into another, in O(1)
+*   phClear		        - Clears the contents of the pairing heap. Frees all the elements using the free functions.
+*/
+
+/** Type for defining the pairing heap */
+typedef struct PairingHeap_t *PairingHeap;
+
+/** Handle of an element in a pairing heap, valid from its insertion until it is removed (even after a meld) */
+typedef struct PHNode_t *PHNode;
+
+/**
+* phCreate: Allocates a new empty pairing heap.
+*
+* @param copy_element - Function pointer to be used for copying data elements into the pairing heap.
+* @param free_element - Function pointer to be used for removing data elements from the pairing heap.
+* @param copy_priority - Function pointer to be used for copying priority into the pairing heap.
+* @param free_priority - Function pointer to be used for removing priority from the pairing heap.
+* @param compare_priorities - Function pointer to be used for comparing priority of elements.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new pairing heap in case of success.
+*/
+PairingHeap phCreate(CopyPQElement copy_element,
+                     FreePQElement free_element,
+                     CopyPQElementPriority copy_priority,
+                     FreePQElementPriority free_priority,
+                     ComparePQElementPriorities compare_priorities);
+
+/**
+* phDestroy: Deallocates an existing pairing heap. Clears all elements by using the free functions.
+*
+* @param heap - Target pairing heap to be deallocated. If it is NULL nothing will be done
+*/
+void phDestroy(PairingHeap heap);
+
+/**
+* phGetSize: Returns the number of elements in a pairing heap.
+* @param heap - The pairing heap which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the pairing heap.
+*/
+int phGetSize(PairingHeap heap);
+
+/**
+*   phInsert: add a specified element with a specific priority, in O(1).
+*
+* @param heap - The pairing heap for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The new priority to associate with the given element.
+*      A copy of the element will be inserted as supplied by the copying function
+*      which is given at initialization.
+* @param node - Set to the handle of the new element, to change its priority with. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as heap, element or priority
+* 	PQ_OUT_OF_MEMORY if an allocation failed (Meaning the function for copying
+* 	an element failed)
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult phInsert(PairingHeap heap, PQElement element, PQElementPriority priority, PHNode* node);
+
+/**
+*   phPeek: Returns the highest priority element in the pairing heap (the one phPop would remove),
+*   and its priority, without removing it.
+*
+* @param heap - The pairing heap to look at.
+* @param element - Set to the element, which still belongs to the pairing heap. Ignored if NULL.
+* @param priority - Set to the priority of the element, which still belongs to the pairing heap. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as heap.
+* 	PQ_ITEM_DOES_NOT_EXIST if the pairing heap is empty.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult phPeek(PairingHeap heap, PQElement* element, PQElementPriority* priority);
+
+/**
+*   phPop: Removes the highest priority element from the pairing heap, and hands it to the caller,
+*   in amortized O(log n). Its handle is invalid after this operation.
+*
+* @param heap - The pairing heap to remove the element from.
+* @param element - Set to the removed element, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @param priority - Set to the priority of the removed element, which the caller is responsible for freeing.
+* 		If NULL, the priority is freed using the free function given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as heap.
+* 	PQ_ITEM_DOES_NOT_EXIST if the pairing heap is empty.
+* 	PQ_SUCCESS the element had been removed successfully.
+*/
+PriorityQueueResult phPop(PairingHeap heap, PQElement* element, PQElementPriority* priority);
+
+/**
+*   phChangePriority: Changes the priority of an element of the pairing heap, given its handle.
+*   Like pqChangePriority, the element is then removed after the elements with an equal priority.
+*   Raising the priority takes amortized o(log n), lowering it amortized O(log n).
+*
+* @param heap - The pairing heap that holds the element.
+* @param node - The handle of the element, as returned by phInsert. Must not have been removed.
+* @param new_priority - The new priority of the element. A copy of it is made with the copying function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters.
+* 	PQ_OUT_OF_MEMORY if an allocation failed. The element keeps its old priority in that case.
+* 	PQ_SUCCESS the priority had been changed successfully.
+*/
+PriorityQueueResult phChangePriority(PairingHeap heap, PHNode node, PQElementPriority new_priority);
+
+/**
+*   phMeld: Moves all the elements of source into destination in O(1), leaving source empty.
+*   The handles of the moved elements stay valid, as handles of elements of destination.
+*
+* @param destination - The pairing heap to add the elements to.
+* @param source - The pairing heap to take the elements from. Must have the same free and compare
+*       functions as destination.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters.
+* 	PQ_ERROR if the heaps are the same heap, or their free or compare functions are different.
+* 	PQ_SUCCESS the elements had been moved successfully.
+*/
+PriorityQueueResult phMeld(PairingHeap destination, PairingHeap source);
+
+/**
+*   phClear: Removes all elements and priorities from the pairing heap. They are deallocated using
+*   the free functions.
+*
+* @param heap - Target pairing heap to remove all element from.
+* @return
+* 	PQ_NULL_ARGUMENT - if a NULL pointer was sent.
+* 	PQ_SUCCESS - Otherwise.
+*/
+PriorityQueueResult phClear(PairingHeap heap);
+
+#endif /* PAIRING_HEAP_H */
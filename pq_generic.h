@@ -0,0 +1,397 @@
+#ifndef PQ_GENERIC_H
+#define PQ_GENERIC_H
+
+#include <stdbool.h>
+#include <stdlib.h>
+#include <string.h>
+#include "priority_queue.h"
+
+/**
+* Type-Specialized Priority Queue
+*
+* PQ_DECLARE generates a priority queue type for specific element and priority types, with the same
+* operations (and the same order of elements) as the generic priority queue in priority_queue.h.
+* Elements and priorities are stored by value and compared with a function or macro known at compile time,
+* so the compiler can inline the comparisons instead of calling through function pointers.
+*
+* PQ_DECLARE(name, ElemT, PrioT, cmp) declares:
+*   name			    - The queue type (a pointer, like PriorityQueue)
+*   name##Create	    - Creates a new empty priority queue
+*   name##Destroy	    - Deletes an existing priority queue
+*   name##Copy	        - Copies an existing priority queue
+*   name##GetSize	    - Returns the size of a given priority queue, -1 if NULL
+*   name##Contains	    - returns whether or not an element exists inside the priority queue
+*   name##Insert	    - Insert an element with a given priority to the queue
+*   name##ChangePriority- Changes priority of an element with specific priority
+*   name##Remove	    - Removes the highest priority element in the queue
+*   name##Pop		    - Removes the highest priority element in the queue and copies it out
+*   name##RemoveElement - Removes the highest priority element which is equal to a given element
+*   name##GetFirst	    - Sets the internal iterator to the first element and returns a pointer to it
+*   name##GetNext	    - Advances the internal iterator to the next element and returns a pointer to it
+*   name##Clear	        - Clears the contents of the priority queue
+*
+* The functions behave like their pq* counterparts (same results and same iterator rules), except that
+* elements and priorities are passed by value, and pointers returned by the iterator functions are
+* valid only until the queue is changed.
+*
+* @param name - The name of the queue type, also used as the prefix of its functions.
+* @param ElemT - The type of the elements.
+* @param PrioT - The type of the priorities.
+* @param cmp - Function or macro comparing two priorities, with the same contract as
+* 		ComparePQElementPriorities: positive if the first has the higher priority, 0 if equal.
+*
+* Elements are compared byte by byte (memcmp). PQ_DECLARE_EX takes an element equality function or macro
+* (true if equal) as a fifth parameter, for element types that need more than that (e.g. padded structs).
+*
+* Example:
+*   #define compareInts(a, b) (((a) > (b)) - ((a) < (b)))
+*   PQ_DECLARE(IntPQ, int, int, compareInts)
+*   ...
+*   IntPQ queue = IntPQCreate();
+*   IntPQInsert(queue, 5, 2);
+*/
+
+/** Sizes of the arrays of a generated queue, same as in priority_queue.c */
+#define PQ_GENERIC_INITIAL_SIZE 10
+#define PQ_GENERIC_EXPAND_RATE 2
+
+/**
+* Macro for iterating over a generated queue's elements, as PQ_FOREACH does.
+* Declares an element pointer with the given name, which points to the current element.
+*/
+#define PQ_GENERIC_FOREACH(name, ElemT, iterator, queue) \
+    for(ElemT* iterator = name##GetFirst(queue) ; \
+        iterator ;\
+        iterator = name##GetNext(queue))
+
+#define PQ_DECLARE(name, ElemT, PrioT, cmp) \
+static inline bool name##EqualBytes(ElemT first, ElemT second) { \
+    return memcmp(&first, &second, sizeof(ElemT)) == 0; \
+} \
+PQ_DECLARE_EX(name, ElemT, PrioT, cmp, name##EqualBytes)
+
+#define PQ_DECLARE_EX(name, ElemT, PrioT, cmp, eq) \
+\
+/* an element, its priority, and its insertion sequence for keeping equal priorities in insertion order */ \
+typedef struct { \
+    ElemT element; \
+    PrioT priority; \
+    unsigned long sequence; \
+} name##Entry; \
+\
+typedef struct name##_t { \
+    name##Entry* heap; /* the entries, ordered as a binary heap */ \
+    int size; \
+    int max_size; \
+    unsigned long next_sequence; \
+    /* the internal iterator: heap positions that weren't returned yet, but whose parents were */ \
+    int* frontier; \
+    int frontier_size; \
+    bool iterator_defined; \
+} *name; \
+\
+/* returns true if first should be removed before second */ \
+static inline bool name##ComesFirst(const name##Entry* first, const name##Entry* second) { \
+    int comparison = cmp(first->priority, second->priority); \
+    if(comparison != 0) { \
+        return comparison > 0; \
+    } \
+    return first->sequence < second->sequence; \
+} \
+\
+/* moves the entry at position up until its parent comes before it, returns its final position */ \
+static inline int name##SiftUp(name queue, int position) { \
+    name##Entry entry = queue->heap[position]; \
+    while(position > 0) { \
+        int parent = (position - 1) / 2; \
+        if(!name##ComesFirst(&entry, &queue->heap[parent])) { \
+            break; \
+        } \
+        queue->heap[position] = queue->heap[parent]; \
+        position = parent; \
+    } \
+    queue->heap[position] = entry; \
+    return position; \
+} \
+\
+/* moves the entry at position down until it comes before its children */ \
+static inline void name##SiftDown(name queue, int position) { \
+    name##Entry entry = queue->heap[position]; \
+    while(2 * position + 1 < queue->size) { \
+        int child = 2 * position + 1; \
+        if(child + 1 < queue->size && name##ComesFirst(&queue->heap[child + 1], &queue->heap[child])) { \
+            child++; \
+        } \
+        if(!name##ComesFirst(&queue->heap[child], &entry)) { \
+            break; \
+        } \
+        queue->heap[position] = queue->heap[child]; \
+        position = child; \
+    } \
+    queue->heap[position] = entry; \
+} \
+\
+/* restores the heap after the entry at position was changed */ \
+static inline void name##RestoreAt(name queue, int position) { \
+    if(name##SiftUp(queue, position) == position) { \
+        name##SiftDown(queue, position); \
+    } \
+} \
+\
+/* expands the heap and the frontier by PQ_GENERIC_EXPAND_RATE */ \
+static inline PriorityQueueResult name##Expand(name queue) { \
+    int new_size = queue->max_size * PQ_GENERIC_EXPAND_RATE; \
+    name##Entry* new_heap = realloc(queue->heap, new_size * sizeof(name##Entry)); \
+    if(new_heap == NULL) { \
+        return PQ_OUT_OF_MEMORY; \
+    } \
+    queue->heap = new_heap; \
+    int* new_frontier = realloc(queue->frontier, new_size * sizeof(int)); \
+    if(new_frontier == NULL) { \
+        return PQ_OUT_OF_MEMORY; \
+    } \
+    queue->frontier = new_frontier; \
+    queue->max_size = new_size; \
+    return PQ_SUCCESS; \
+} \
+\
+/* returns the position of the first entry (by removal order) with an element equal to element, */ \
+/* and also with a priority equal to *priority if priority isn't NULL. -1 if there is none */ \
+static inline int name##FindPosition(name queue, ElemT element, const PrioT* priority) { \
+    int found = -1; \
+    for(int position = 0; position < queue->size; position++) { \
+        name##Entry* entry = &queue->heap[position]; \
+        if(!eq(entry->element, element)) { \
+            continue; \
+        } \
+        if(priority != NULL && cmp(entry->priority, *priority) != 0) { \
+            continue; \
+        } \
+        if(found == -1 || name##ComesFirst(entry, &queue->heap[found])) { \
+            found = position; \
+        } \
+    } \
+    return found; \
+} \
+\
+/* removes the entry at position, and restores the heap */ \
+static inline void name##RemoveAt(name queue, int position) { \
+    queue->size--; \
+    if(position < queue->size) { \
+        queue->heap[position] = queue->heap[queue->size]; \
+        name##RestoreAt(queue, position); \
+    } \
+    queue->iterator_defined = false; \
+} \
+\
+static inline name name##Create(void) { \
+    name queue = malloc(sizeof(*queue)); \
+    if(queue == NULL) { \
+        return NULL; \
+    } \
+    queue->heap = malloc(PQ_GENERIC_INITIAL_SIZE * sizeof(name##Entry)); \
+    queue->frontier = malloc(PQ_GENERIC_INITIAL_SIZE * sizeof(int)); \
+    if(queue->heap == NULL || queue->frontier == NULL) { \
+        free(queue->heap); \
+        free(queue->frontier); \
+        free(queue); \
+        return NULL; \
+    } \
+    queue->size = 0; \
+    queue->max_size = PQ_GENERIC_INITIAL_SIZE; \
+    queue->next_sequence = 0; \
+    queue->frontier_size = 0; \
+    queue->iterator_defined = false; \
+    return queue; \
+} \
+\
+static inline void name##Destroy(name queue) { \
+    if(queue == NULL) { \
+        return; \
+    } \
+    free(queue->heap); \
+    free(queue->frontier); \
+    free(queue); \
+} \
+\
+static inline name name##Copy(name queue) { \
+    if(queue == NULL) { \
+        return NULL; \
+    } \
+    name new_queue = malloc(sizeof(*new_queue)); \
+    if(new_queue == NULL) { \
+        return NULL; \
+    } \
+    new_queue->heap = malloc(queue->max_size * sizeof(name##Entry)); \
+    new_queue->frontier = malloc(queue->max_size * sizeof(int)); \
+    if(new_queue->heap == NULL || new_queue->frontier == NULL) { \
+        name##Destroy(new_queue); \
+        return NULL; \
+    } \
+    /* the entries are plain values, so the heap is copied as is */ \
+    memcpy(new_queue->heap, queue->heap, queue->size * sizeof(name##Entry)); \
+    new_queue->size = queue->size; \
+    new_queue->max_size = queue->max_size; \
+    new_queue->next_sequence = queue->next_sequence; \
+    new_queue->frontier_size = 0; \
+    new_queue->iterator_defined = false; \
+    queue->iterator_defined = false; \
+    return new_queue; \
+} \
+\
+static inline int name##GetSize(name queue) { \
+    if(queue == NULL) { \
+        return -1; \
+    } \
+    return queue->size; \
+} \
+\
+static inline bool name##Contains(name queue, ElemT element) { \
+    if(queue == NULL) { \
+        return false; \
+    } \
+    for(int position = 0; position < queue->size; position++) { \
+        if(eq(queue->heap[position].element, element)) { \
+            return true; \
+        } \
+    } \
+    return false; \
+} \
+\
+static inline PriorityQueueResult name##Insert(name queue, ElemT element, PrioT priority) { \
+    if(queue == NULL) { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    if(queue->size == queue->max_size && name##Expand(queue) == PQ_OUT_OF_MEMORY) { \
+        return PQ_OUT_OF_MEMORY; \
+    } \
+    name##Entry* entry = &queue->heap[queue->size++]; \
+    entry->element = element; \
+    entry->priority = priority; \
+    entry->sequence = queue->next_sequence++; \
+    name##SiftUp(queue, queue->size - 1); \
+    queue->iterator_defined = false; \
+    return PQ_SUCCESS; \
+} \
+\
+static inline PriorityQueueResult name##ChangePriority(name queue, ElemT element, \
+                                                       PrioT old_priority, PrioT new_priority) { \
+    if(queue == NULL) { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    queue->iterator_defined = false; \
+    int position = name##FindPosition(queue, element, &old_priority); \
+    if(position == -1) { \
+        return PQ_ELEMENT_DOES_NOT_EXISTS; \
+    } \
+    /* the element is considered as reinserted, so it gets a new sequence number */ \
+    queue->heap[position].priority = new_priority; \
+    queue->heap[position].sequence = queue->next_sequence++; \
+    name##RestoreAt(queue, position); \
+    return PQ_SUCCESS; \
+} \
+\
+static inline PriorityQueueResult name##Remove(name queue) { \
+    if(queue == NULL) { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    if(queue->size > 0) { \
+        name##RemoveAt(queue, 0); \
+    } \
+    return PQ_SUCCESS; \
+} \
+\
+static inline PriorityQueueResult name##Pop(name queue, ElemT* element, PrioT* priority) { \
+    if(queue == NULL) { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    if(queue->size == 0) { \
+        return PQ_ITEM_DOES_NOT_EXIST; \
+    } \
+    if(element != NULL) { \
+        *element = queue->heap[0].element; \
+    } \
+    if(priority != NULL) { \
+        *priority = queue->heap[0].priority; \
+    } \
+    name##RemoveAt(queue, 0); \
+    return PQ_SUCCESS; \
+} \
+\
+static inline PriorityQueueResult name##RemoveElement(name queue, ElemT element) { \
+    if(queue == NULL) { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    queue->iterator_defined = false; \
+    int position = name##FindPosition(queue, element, NULL); \
+    if(position == -1) { \
+        return PQ_ELEMENT_DOES_NOT_EXISTS; \
+    } \
+    name##RemoveAt(queue, position); \
+    return PQ_SUCCESS; \
+} \
+\
+static inline ElemT* name##GetNext(name queue) { \
+    if(queue == NULL || !queue->iterator_defined || queue->frontier_size == 0) { \
+        if(queue != NULL) { \
+            queue->iterator_defined = false; \
+        } \
+        return NULL; \
+    } \
+    /* the frontier is a heap of positions: takes its first one out */ \
+    int* frontier = queue->frontier; \
+    int current = frontier[0]; \
+    int last = frontier[--queue->frontier_size]; \
+    int index = 0; \
+    while(2 * index + 1 < queue->frontier_size) { \
+        int child = 2 * index + 1; \
+        if(child + 1 < queue->frontier_size && \
+           name##ComesFirst(&queue->heap[frontier[child + 1]], &queue->heap[frontier[child]])) { \
+            child++; \
+        } \
+        if(!name##ComesFirst(&queue->heap[frontier[child]], &queue->heap[last])) { \
+            break; \
+        } \
+        frontier[index] = frontier[child]; \
+        index = child; \
+    } \
+    frontier[index] = last; \
+    /* the children of the returned position are the next candidates */ \
+    for(int child = 2 * current + 1; child <= 2 * current + 2 && child < queue->size; child++) { \
+        index = queue->frontier_size++; \
+        while(index > 0) { \
+            int parent = (index - 1) / 2; \
+            if(!name##ComesFirst(&queue->heap[child], &queue->heap[frontier[parent]])) { \
+                break; \
+            } \
+            frontier[index] = frontier[parent]; \
+            index = parent; \
+        } \
+        frontier[index] = child; \
+    } \
+    return &queue->heap[current].element; \
+} \
+\
+static inline ElemT* name##GetFirst(name queue) { \
+    if(queue == NULL || queue->size == 0) { \
+        if(queue != NULL) { \
+            queue->iterator_defined = false; \
+        } \
+        return NULL; \
+    } \
+    queue->frontier[0] = 0; \
+    queue->frontier_size = 1; \
+    queue->iterator_defined = true; \
+    return name##GetNext(queue); \
+} \
+\
+static inline PriorityQueueResult name##Clear(name queue) { \
+    if(queue == NULL) { \
+        return PQ_NULL_ARGUMENT; \
+    } \
+    queue->size = 0; \
+    queue->iterator_defined = false; \
+    return PQ_SUCCESS; \
+}
+
+#endif /* PQ_GENERIC_H */
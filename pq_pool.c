@@ -0,0 +1,135 @@
+#include "pq_pool.h"
+
+/*----------------------------------------------------------------------
+                         Implementation types
+ ----------------------------------------------------------------------*/
+
+// the strictest alignment of a basic type. every object starts at a multiple of its size
+typedef union MaxAlignUnion {
+    long double long_double_member;
+    long long long_long_member;
+    void* pointer_member;
+    void (*function_member)(void);
+} MaxAlign;
+
+// a free object of the pool. free objects are linked through their own memory
+typedef struct FreeObjectStruct {
+    struct FreeObjectStruct* next;
+} FreeObject;
+
+// the header of a slab. the slab's objects come right after it
+typedef union SlabUnion {
+    union SlabUnion* next;
+    MaxAlign alignment;
+} Slab;
+
+struct PQPool_t {
+    //size of every object, rounded up so that every object in a slab is aligned
+    size_t object_size;
+
+    //number of objects in every slab
+    int objects_per_slab;
+
+    //all the slabs of the pool, linked through their headers
+    Slab* slabs;
+
+    //the objects that can be allocated without a new slab
+    FreeObject* free_objects;
+
+    //the allocator of the pool and its slabs
+    PQAllocator allocator;
+};
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// allocates a new slab, and links all of its objects in front of the free objects
+static bool addSlab(PQPool pool) {
+    Slab* slab = pool->allocator.alloc(pool->allocator.context,
+                                       sizeof(Slab) + pool->object_size * pool->objects_per_slab);
+    if(slab == NULL) {
+        return false;
+    }
+    slab->next = pool->slabs;
+    pool->slabs = slab;
+
+    char* objects = (char*)(slab + 1);
+    for(int object = pool->objects_per_slab - 1; object >= 0; object--) {
+        FreeObject* free_object = (FreeObject*)(objects + object * pool->object_size);
+        free_object->next = pool->free_objects;
+        pool->free_objects = free_object;
+    }
+    return true;
+}
+
+/*----------------------------------------------------------------------
+                            Pool functions
+ ----------------------------------------------------------------------*/
+
+PQPool pqPoolCreate(size_t object_size, int objects_per_slab, const PQAllocator* allocator) {
+    if(object_size == 0 || objects_per_slab <= 0) {
+        return NULL;
+    }
+    PQAllocator pool_allocator = *pqDefaultAllocator();
+    if(allocator != NULL) {
+        if(allocator->alloc == NULL || allocator->free == NULL) {
+            return NULL;
+        }
+        pool_allocator = *allocator;
+    }
+
+    PQPool pool = pool_allocator.alloc(pool_allocator.context, sizeof(*pool));
+    if(pool == NULL) {
+        return NULL;
+    }
+
+    // an object must be able to hold the free list link, and keep the next object aligned
+    if(object_size < sizeof(FreeObject)) {
+        object_size = sizeof(FreeObject);
+    }
+    pool->object_size = (object_size + sizeof(MaxAlign) - 1) / sizeof(MaxAlign) * sizeof(MaxAlign);
+    pool->objects_per_slab = objects_per_slab;
+    pool->slabs = NULL;
+    pool->free_objects = NULL;
+    pool->allocator = pool_allocator;
+
+    return pool;
+}
+
+void pqPoolDestroy(PQPool pool) {
+    if(pool == NULL) {
+        return;
+    }
+
+    PQAllocator allocator = pool->allocator;
+    while(pool->slabs != NULL) {
+        Slab* next = pool->slabs->next;
+        allocator.free(allocator.context, pool->slabs);
+        pool->slabs = next;
+    }
+    allocator.free(allocator.context, pool);
+}
+
+void* pqPoolAlloc(PQPool pool) {
+    if(pool == NULL) {
+        return NULL;
+    }
+    if(pool->free_objects == NULL && !addSlab(pool)) {
+        return NULL;
+    }
+
+    FreeObject* object = pool->free_objects;
+    pool->free_objects = object->next;
+    return object;
+}
+
+void pqPoolFree(PQPool pool, void* object) {
+    if(pool == NULL || object == NULL) {
+        return;
+    }
+
+    FreeObject* free_object = object;
+    free_object->next = pool->free_objects;
+    pool->free_objects = free_object;
+}
@@ -0,0 +1,79 @@
+#ifndef PQ_POOL_H
+#define PQ_POOL_H
+
+#include <stddef.h>
+#include "priority_queue.h"
+
+/**
+* Fixed-Size Object Pool
+*
+* Implements a slab allocator for objects of a single size, such as the copies of elements and priorities
+* that the copy functions of a priority queue make on every insertion.
+* Objects are carved out of slabs of many objects at once, and freed objects are reused by the next
+* allocations, so allocating and freeing an object doesn't call the underlying allocator at all
+* (except when a new slab is needed).
+*
+* The following functions are available:
+*   pqPoolCreate		- Creates a new empty pool
+*   pqPoolDestroy		- Deletes a pool, and frees all of its slabs (and every object in them)
+*   pqPoolAlloc		    - Allocates an object from the pool
+*   pqPoolFree		    - Returns an object to the pool
+*
+* Example, copy and free functions of int elements:
+*   static PQPool int_pool;
+*   PQElement copyInt(PQElement n) {
+*       int* copy = pqPoolAlloc(int_pool);
+*       if(copy != NULL) {
+*           *copy = *(int*)n;
+*       }
+*       return copy;
+*   }
+*   void freeInt(PQElement n) {
+*       pqPoolFree(int_pool, n);
+*   }
+*/
+
+/** Type for defining the pool */
+typedef struct PQPool_t *PQPool;
+
+/**
+* pqPoolCreate: Allocates a new empty pool.
+*
+* @param object_size - The size in bytes of every object in the pool. Must be positive.
+* @param objects_per_slab - The number of objects allocated together in each slab. Must be positive.
+* @param allocator - The allocator the pool and its slabs are allocated with (see PQAllocator).
+* 		If NULL, malloc and free are used.
+* @return
+* 	NULL - if one of the sizes is invalid or allocations failed.
+* 	A new pool in case of success.
+*/
+PQPool pqPoolCreate(size_t object_size, int objects_per_slab, const PQAllocator* allocator);
+
+/**
+* pqPoolDestroy: Deallocates a pool, with all of its slabs. Every object allocated from the pool
+* is freed with it, and must not be used anymore.
+*
+* @param pool - Target pool to be deallocated. If pool is NULL nothing will be done
+*/
+void pqPoolDestroy(PQPool pool);
+
+/**
+* pqPoolAlloc: Allocates an object of the pool's object size.
+* The object is suitably aligned for any type, like memory returned from malloc.
+*
+* @param pool - The pool to allocate the object from.
+* @return
+* 	NULL if a NULL was sent or an allocation failed.
+* 	A pointer to the new object otherwise.
+*/
+void* pqPoolAlloc(PQPool pool);
+
+/**
+* pqPoolFree: Returns an object to the pool, to be reused by the next allocations.
+*
+* @param pool - The pool the object was allocated from.
+* @param object - The object to free. If NULL nothing will be done.
+*/
+void pqPoolFree(PQPool pool, void* object);
+
+#endif /* PQ_POOL_H */
@@ -0,0 +1,221 @@
+#include "pq_simd.h"
+#include <assert.h>
+#include <math.h>
+#include <stdint.h>
+#include <string.h>
+
+// the SSE4.1 and AVX2 kernels are built with target attributes, so the rest of the code doesn't need
+// those instruction sets: they are only called once CPUID showed the CPU has them
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define PQ_SIMD_X86 1
+#include <immintrin.h>
+#define TARGET(isa) __attribute__((target(isa)))
+#else
+#define PQ_SIMD_X86 0
+#endif
+
+/*----------------------------------------------------------------------
+                         Implementation constants
+ ----------------------------------------------------------------------*/
+
+// the primitive priority types, PQ_PRIORITY_INT32 to PQ_PRIORITY_DOUBLE
+#define TYPE_COUNT 3
+
+// the instruction set levels the kernels are built for
+#define LEVEL_COUNT (PQ_SIMD_X86 ? 3 : 1)
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// returns a mask of the lowest count bits
+static unsigned firstBits(int count) {
+    return (1u << count) - 1;
+}
+
+// scalar kernels of a priority type, used when the CPU has no SIMD instructions that fit
+#define SCALAR_KERNELS(name, type)                                                  \
+static unsigned name##MaximumMaskScalar(const void* values, int count) {            \
+    assert(count > 0 && count <= PQ_SIMD_MAX_MASK_COUNT);                           \
+    const type* typed = values;                                                     \
+    type maximum = typed[0];                                                        \
+    unsigned mask = 1;                                                              \
+    for(int i = 1; i < count; i++) {                                                \
+        if(typed[i] > maximum) {                                                    \
+            maximum = typed[i];                                                     \
+            mask = 1u << i;                                                         \
+        } else if(typed[i] == maximum) {                                            \
+            mask |= 1u << i;                                                        \
+        }                                                                           \
+    }                                                                               \
+    return mask;                                                                    \
+}
+
+SCALAR_KERNELS(int32, int32_t)
+SCALAR_KERNELS(float, float)
+SCALAR_KERNELS(double, double)
+
+#if PQ_SIMD_X86
+
+// copies count values of size bytes each to padded, and fills the rest of its PQ_SIMD_MAX_MASK_COUNT
+// values with lowest, so a kernel can load whole vectors without reading past the end of values
+static void padValues(void* padded, const void* values, int count, size_t size, const void* lowest) {
+    assert(count > 0 && count <= PQ_SIMD_MAX_MASK_COUNT);
+    memcpy(padded, values, (size_t)count * size);
+    for(int i = count; i < PQ_SIMD_MAX_MASK_COUNT; i++) {
+        memcpy((char*)padded + (size_t)i * size, lowest, size);
+    }
+}
+
+/*----------------------------------------------------------------------
+                              SSE4.1 kernels
+ ----------------------------------------------------------------------*/
+
+static TARGET("sse4.1") unsigned int32MaximumMaskSse41(const void* values, int count) {
+    const int32_t lowest = INT32_MIN;
+    int32_t padded[PQ_SIMD_MAX_MASK_COUNT];
+    padValues(padded, values, count, sizeof(int32_t), &lowest);
+    __m128i low = _mm_loadu_si128((const __m128i*)padded);
+    __m128i high = _mm_loadu_si128((const __m128i*)(padded + 4));
+
+    // the maximum of every lane, then of the lanes, then which values are equal to it
+    __m128i maximum = _mm_max_epi32(low, high);
+    maximum = _mm_max_epi32(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+    maximum = _mm_max_epi32(maximum, _mm_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+    unsigned mask = (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, maximum))) |
+                    (unsigned)_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, maximum))) << 4;
+    return mask & firstBits(count);
+}
+
+static TARGET("sse4.1") unsigned floatMaximumMaskSse41(const void* values, int count) {
+    const float lowest = -INFINITY;
+    float padded[PQ_SIMD_MAX_MASK_COUNT];
+    padValues(padded, values, count, sizeof(float), &lowest);
+    __m128 low = _mm_loadu_ps(padded);
+    __m128 high = _mm_loadu_ps(padded + 4);
+
+    __m128 maximum = _mm_max_ps(low, high);
+    maximum = _mm_max_ps(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+    maximum = _mm_max_ps(maximum, _mm_shuffle_ps(maximum, maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+    unsigned mask = (unsigned)_mm_movemask_ps(_mm_cmpeq_ps(low, maximum)) |
+                    (unsigned)_mm_movemask_ps(_mm_cmpeq_ps(high, maximum)) << 4;
+    return mask & firstBits(count);
+}
+
+static TARGET("sse4.1") unsigned doubleMaximumMaskSse41(const void* values, int count) {
+    const double lowest = -INFINITY;
+    double padded[PQ_SIMD_MAX_MASK_COUNT];
+    padValues(padded, values, count, sizeof(double), &lowest);
+    __m128d quarters[4];
+    for(int i = 0; i < 4; i++) {
+        quarters[i] = _mm_loadu_pd(padded + 2 * i);
+    }
+
+    __m128d maximum = _mm_max_pd(_mm_max_pd(quarters[0], quarters[1]), _mm_max_pd(quarters[2], quarters[3]));
+    maximum = _mm_max_pd(maximum, _mm_shuffle_pd(maximum, maximum, 1));
+    unsigned mask = 0;
+    for(int i = 0; i < 4; i++) {
+        mask |= (unsigned)_mm_movemask_pd(_mm_cmpeq_pd(quarters[i], maximum)) << (2 * i);
+    }
+    return mask & firstBits(count);
+}
+
+/*----------------------------------------------------------------------
+                               AVX2 kernels
+ ----------------------------------------------------------------------*/
+
+// returns the lanes of an 8 lane vector that hold one of the first count values (all bits set in them)
+static TARGET("avx2") __m256i usedLanes(int count) {
+    return _mm256_cmpgt_epi32(_mm256_set1_epi32(count), _mm256_set_epi32(7, 6, 5, 4, 3, 2, 1, 0));
+}
+
+// all the children of a position of an 8-ary heap fit in one vector: one masked load, a max across
+// the lanes and one compare find all of the highest ones
+static TARGET("avx2") unsigned int32MaximumMaskAvx2(const void* values, int count) {
+    assert(count > 0 && count <= PQ_SIMD_MAX_MASK_COUNT);
+    __m256i used = usedLanes(count);
+    __m256i loaded = _mm256_maskload_epi32((const int*)values, used);
+    __m256i vector = _mm256_blendv_epi8(_mm256_set1_epi32(INT32_MIN), loaded, used);
+
+    __m256i maximum = _mm256_max_epi32(vector, _mm256_permute2x128_si256(vector, vector, 1));
+    maximum = _mm256_max_epi32(maximum, _mm256_shuffle_epi32(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+    maximum = _mm256_max_epi32(maximum, _mm256_shuffle_epi32(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m256i equal = _mm256_and_si256(_mm256_cmpeq_epi32(vector, maximum), used);
+    return (unsigned)_mm256_movemask_ps(_mm256_castsi256_ps(equal));
+}
+
+static TARGET("avx2") unsigned floatMaximumMaskAvx2(const void* values, int count) {
+    assert(count > 0 && count <= PQ_SIMD_MAX_MASK_COUNT);
+    __m256 used = _mm256_castsi256_ps(usedLanes(count));
+    __m256 loaded = _mm256_maskload_ps((const float*)values, _mm256_castps_si256(used));
+    __m256 vector = _mm256_blendv_ps(_mm256_set1_ps(-INFINITY), loaded, used);
+
+    __m256 maximum = _mm256_max_ps(vector, _mm256_permute2f128_ps(vector, vector, 1));
+    maximum = _mm256_max_ps(maximum, _mm256_permute_ps(maximum, _MM_SHUFFLE(1, 0, 3, 2)));
+    maximum = _mm256_max_ps(maximum, _mm256_permute_ps(maximum, _MM_SHUFFLE(2, 3, 0, 1)));
+    __m256 equal = _mm256_and_ps(_mm256_cmp_ps(vector, maximum, _CMP_EQ_OQ), used);
+    return (unsigned)_mm256_movemask_ps(equal);
+}
+
+static TARGET("avx2") unsigned doubleMaximumMaskAvx2(const void* values, int count) {
+    const double lowest = -INFINITY;
+    double padded[PQ_SIMD_MAX_MASK_COUNT];
+    padValues(padded, values, count, sizeof(double), &lowest);
+    __m256d low = _mm256_loadu_pd(padded);
+    __m256d high = _mm256_loadu_pd(padded + 4);
+
+    __m256d maximum = _mm256_max_pd(low, high);
+    maximum = _mm256_max_pd(maximum, _mm256_permute2f128_pd(maximum, maximum, 1));
+    maximum = _mm256_max_pd(maximum, _mm256_permute_pd(maximum, 5));
+    unsigned mask = (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(low, maximum, _CMP_EQ_OQ)) |
+                    (unsigned)_mm256_movemask_pd(_mm256_cmp_pd(high, maximum, _CMP_EQ_OQ)) << 4;
+    return mask & firstBits(count);
+}
+
+#endif /* PQ_SIMD_X86 */
+
+// the kernels of every level, by level and then by priority type
+static const PQSimdKernels kernel_table[LEVEL_COUNT][TYPE_COUNT] = {
+    {
+        {int32MaximumMaskScalar},
+        {floatMaximumMaskScalar},
+        {doubleMaximumMaskScalar}
+    },
+#if PQ_SIMD_X86
+    {
+        {int32MaximumMaskSse41},
+        {floatMaximumMaskSse41},
+        {doubleMaximumMaskSse41}
+    },
+    {
+        {int32MaximumMaskAvx2},
+        {floatMaximumMaskAvx2},
+        {doubleMaximumMaskAvx2}
+    }
+#endif
+};
+
+/*----------------------------------------------------------------------
+                            Kernel selection
+ ----------------------------------------------------------------------*/
+
+PQSimdLevel pqSimdBestLevel(void) {
+#if PQ_SIMD_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2")) {
+        return PQ_SIMD_AVX2;
+    }
+    if(__builtin_cpu_supports("sse4.1")) {
+        return PQ_SIMD_SSE41;
+    }
+#endif
+    return PQ_SIMD_SCALAR;
+}
+
+const PQSimdKernels* pqSimdKernels(PQPriorityType type, PQSimdLevel level) {
+    if(type < PQ_PRIORITY_INT32 || type > PQ_PRIORITY_DOUBLE || level < PQ_SIMD_SCALAR ||
+       level > pqSimdBestLevel()) {
+        return NULL;
+    }
+    return &kernel_table[level][type - PQ_PRIORITY_INT32];
+}
@@ -0,0 +1,57 @@
+#ifndef PQ_SIMD_H
+#define PQ_SIMD_H
+
+#include "priority_queue.h"
+
+/**
+* Priority Search Kernels
+*
+* Finds the highest or lowest of a run of primitive priorities (see PQPriorityType), for priority queues
+* with primitive priorities: the children of a position of a d-ary heap.
+* Every kernel has a scalar version, and on x86 an SSE4.1 and an AVX2 version that compare several
+* priorities with each instruction. The versions return the same results, and the best one the CPU
+* supports is selected at runtime, so the same build runs on every x86 CPU.
+* Priorities of floating point types must not be NaN.
+*
+* The following functions are available:
+*   pqSimdBestLevel		- Returns the best instruction set level the CPU supports
+*   pqSimdKernels		- Returns the kernels of a priority type for a given instruction set level
+*/
+
+/** The number of values a maximumMask kernel can search (the most children a heap position can have) */
+#define PQ_SIMD_MAX_MASK_COUNT 8
+
+/** Instruction set levels of the kernels, each one needs the CPU to support all the levels before it */
+typedef enum PQSimdLevel_t {
+    PQ_SIMD_SCALAR,
+    PQ_SIMD_SSE41,
+    PQ_SIMD_AVX2
+} PQSimdLevel;
+
+/** The kernels of one priority type, for one instruction set level */
+typedef struct PQSimdKernels_t {
+    /**
+    * Returns a mask with bit i set if values[i] is the highest of the count values.
+    * count must be between 1 and PQ_SIMD_MAX_MASK_COUNT.
+    */
+    unsigned (*maximumMask)(const void* values, int count);
+} PQSimdKernels;
+
+/**
+* pqSimdBestLevel: Returns the best instruction set level that the CPU supports (detected with CPUID).
+* PQ_SIMD_SCALAR if the CPU isn't x86, or the compiler can't build the SIMD kernels.
+*/
+PQSimdLevel pqSimdBestLevel(void);
+
+/**
+* pqSimdKernels: Returns the kernels of a priority type for an instruction set level.
+*
+* @param type - The type of the priorities. Must not be PQ_PRIORITY_CUSTOM.
+* @param level - The instruction set level. Must be supported by the CPU (at most pqSimdBestLevel()).
+* @return
+* 	NULL if type is PQ_PRIORITY_CUSTOM or invalid, or level is invalid or above pqSimdBestLevel().
+* 	Otherwise the kernels.
+*/
+const PQSimdKernels* pqSimdKernels(PQPriorityType type, PQSimdLevel level);
+
+#endif /* PQ_SIMD_H */
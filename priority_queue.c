@@ -1,8 +1,11 @@
 #include "priority_queue.h"
+#include "pq_simd.h"
 #include <stdio.h>
 #include <assert.h>
+#include <stdint.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
 
 /*----------------------------------------------------------------------
                          Implementation constants
@@ -17,468 +20,2312 @@
 // The factor by which the queue's memory is expanded
 #define EXPAND_RATE 2
 
+// The initial number of buckets in the element index of a hashed queue (must be a power of 2)
+#define INITIAL_INDEX_SIZE 16
+
+// The element index is grown when more than 1/INDEX_LOAD_FACTOR of its buckets are used
+#define INDEX_LOAD_FACTOR 2
+
+// The arity of the heap when none is given, and the highest arity a queue may have
+#define DEFAULT_ARITY 2
+#define MAX_ARITY 8
+
+// The most positions of the heap that come right after a position (see followersOf):
+// MAX_ARITY children, or 2 children and 4 grandchildren in a min-max heap
+#define MAX_FOLLOWERS MAX_ARITY
+
 
 // struct that defines an "element" in the queue.
 // has a type PQElement and a priority
-// "used" is for iterating 
+// "sequence" is the insertion order of the element, used as the tie-breaker between equal priorities
+// "position" is where the element currently sits in the heap
+// "next_equal"/"previous_equal" link the equal elements of a hashed queue
 typedef struct ElementsStruct {
     PQElement element;
-    PQElementPriority priority; 
-    //when the iterator has pointed to (used) this Element, used will be set to true
-    bool used; 
-} Element;                                  
+    PQElementPriority priority;
+    //the value of next_sequence in the queue when this Element was inserted
+    unsigned long sequence;
+    //index in the queue's heap array that holds this Element. kept up to date on every sift.
+    //while the Element is unused, this is the index of the next unused Element instead
+    int position;
+    //the other Elements in list_of_elements that hold an equal element (only used by hashed queues)
+    int next_equal;
+    int previous_equal;
+} Element;
+
+// the priority and sequence of the Element at a position of the heap, kept next to those of the other
+// positions (see heap_keys), so comparing positions doesn't have to load their Elements
+typedef struct HeapKeyStruct {
+    PQElementPriority priority;
+    unsigned long sequence;
+} HeapKey;
+
+// a bucket of the element index of a hashed queue.
+// every bucket stands for one distinct element, and for all the Elements that are equal to it
+typedef struct ElementBucketStruct {
+    //the hash of the element, as returned from hash_element
+    unsigned long hash;
+    //index in list_of_elements of the first of the equal Elements, or ELEMENT_NOT_FOUND if the bucket is empty
+    int first_element;
+    //how many Elements in the queue are equal to this element
+    int count;
+} ElementBucket;
+
+// an iterator over a priority queue, used both for the queue's internal iterator and for PQIterator handles.
+// the iterator walks the heap from the root down: frontier holds the positions in the heap that the
+// iterator hasn't returned yet but whose parent it has returned.
+// the frontier is kept as a binary heap itself, so the next element is always at frontier[0]
+struct PQIterator_t {
+    //the queue that is iterated over
+    PriorityQueue queue;
+
+    //the version of queue when the iteration began. once queue changes, the iterator is undefined
+    unsigned long version;
+
+    //true once the iteration began (until the iterator is cleared)
+    bool defined;
+
+    //positions in the heap of queue, and number of positions in frontier
+    int* frontier;
+    int frontier_size;
+
+    //the allocator of queue, kept by a PQIterator handle so it can be ended after queue was destroyed
+    PQAllocator allocator;
+};
 
 struct PriorityQueue_t {
-    // array of the elements of the queue
-    Element* list_of_elements;                 
-
-    //number of elements in list_of_elements
-    int size; 
-
-    //size of list_of_elements
-    int max_size; 
+    // array of the elements of the queue.
+    // an Element keeps its index in this array for as long as it is in the queue,
+    // so moving elements around the heap never copies the Elements themselves
+    Element* list_of_elements;
+
+    // the heap: indices into list_of_elements, kept as an implicit d-ary heap (d is arity).
+    // the children of heap[i] are heap[d*i+1] to heap[d*i+d],
+    // and no child comes before its parent (see keyComesFirst).
+    // in a double-ended queue it is a (binary) min-max heap instead: no descendant of an Element on an even
+    // (max) level comes before it, and no descendant of an Element on an odd (min) level comes after it
+    int* heap;
+
+    // heap_keys[i] holds the priority and sequence of the Element at heap[i] (see placeElement), so sifting
+    // reads the keys of all the children of a position from one contiguous block instead of d Elements
+    HeapKey* heap_keys;
+
+    //number of children of every position in the heap (2 in a double-ended queue, see PQOptions)
+    int arity;
+
+    // the type of the priorities (see PQOptions). with a primitive type, heap_values[i] is the value of the
+    // priority of the Element at heap[i] (value_size bytes each), and kernels search the values of the
+    // children of a position at once. with PQ_PRIORITY_CUSTOM, value_size is 0 and heap_values and kernels are NULL
+    PQPriorityType priority_type;
+    int value_size;
+    char* heap_values;
+    const PQSimdKernels* kernels;
+
+    //number of elements in the queue (i.e. the used part of heap)
+    int size;
+
+    //size of list_of_elements and of heap
+    int max_size;
+
+    //the capacity is multiplied by growth_factor when the queue is full. once less than
+    //shrink_threshold of it is used (if shrink_threshold is positive), the queue shrinks,
+    //but never below min_capacity (see shrinkIfSparse)
+    double growth_factor;
+    double shrink_threshold;
+    int min_capacity;
+
+    //true if the heap is a min-max heap, so the lowest priority can also be found in O(1) (see PQOptions)
+    bool double_ended;
+
+    //the most elements a bounded queue (see pqCreateBounded) may hold, 0 if the queue is unbounded,
+    //and what an insertion into the full queue does
+    int bound;
+    PQBoundPolicy bound_policy;
+
+    //index of the first unused Element in list_of_elements,
+    //the unused Elements are linked through their "position" field
+    int first_free_element;
+
+    //sequence number given to the next inserted element
+    unsigned long next_sequence;
+
+    //incremented by every operation that changes the queue, which makes all of its iterators undefined
+    unsigned long version;
+
+    // the internal iterator (used by pqGetFirst and pqGetNext). its frontier has room for max_size positions
+    struct PQIterator_t internal_iterator;
+
+    // open addressing (linear probing) multiset of the elements in the queue, only used by hashed queues.
+    // lets pqContains, pqRemoveElement and pqChangePriority find elements without scanning the heap
+    ElementBucket* element_index;
+
+    //number of buckets in element_index (a power of 2) and number of non empty buckets
+    int index_size;
+    int index_used;
+
+    // sizes of the elements and priorities of an inline queue (see pqCreateInline), 0 otherwise.
+    // an inline queue stores the values themselves in element_storage and priority_storage (max_size
+    // values each, the value of list_of_elements[i] at index i) instead of calling the copy and free funcs
+    int element_size;
+    int priority_size;
+    char* element_storage;
+    char* priority_storage;
+
+    // number of queues sharing the storage of the queue (see pqSnapshot), NULL if the storage isn't shared.
+    // the storage is list_of_elements, heap (with heap_keys and heap_values), element_index,
+    // the storage of an inline queue and the elements and priorities themselves
+    int* shared_references;
 
     // function pointers that were defined in the header file
-    CopyPQElement copy_element;
-    FreePQElement free_element;
+    CopyPQElement copy_element; // NULL in an inline queue
+    FreePQElement free_element; // NULL in an inline queue
     EqualPQElements compare_elements;
-    CopyPQElementPriority copy_priority;
-    FreePQElementPriority free_priority;
+    HashPQElement hash_element; // NULL if the queue isn't hashed
+    CopyPQElementPriority copy_priority; // NULL in an inline queue
+    FreePQElementPriority free_priority; // NULL in an inline queue
+    FreePQElementBatch free_element_batch; // NULL unless set with pqSetFreeBatch
+    FreePQElementPriorityBatch free_priority_batch; // NULL unless set with pqSetFreeBatch
     ComparePQElementPriorities compare_priorities;
+
+    // every allocation of the queue goes through allocator (see pqCreateWithAllocator)
+    PQAllocator allocator;
 };
 
 
 /*----------------------------------------------------------------------
-                             Static helper functions
+                            Memory allocation
  ----------------------------------------------------------------------*/
 
-// returns true if queue is empty, false otherwise
-// Note: an empty queue means that the "list_of_elements" in queue is of size 0.
-//      (the size of "list_of_elements" is equal to the "size" field in PriorityQueue_t)
-static bool pqIsEmpty(const PriorityQueue queue) {
-    assert(queue != NULL);
-    if(queue->size == 0) return true;
-    else return false;
+// the allocator of queues that weren't given one: malloc, realloc and free
+static void* defaultAlloc(void* context, size_t size) {
+    (void)context;
+    return malloc(size);
 }
 
-// Returns the highest priority of all of the "list_of_elements" in queue
-// NOTE: does not return the index of the highest priority element in "list_of_elements"
-// returns NULL if queue is empty (i.e. the "list_of_elements" array in queue has 0 enteries)
-static PQElementPriority findHighestPriorityInQueue(const PriorityQueue queue) {
-    assert(queue != NULL);
+static void* defaultRealloc(void* context, void* pointer, size_t size) {
+    (void)context;
+    return realloc(pointer, size);
+}
 
-    // queue is empty, therefore there is no element with 
-    // highest priority because there are no elements in queue
-    if(pqIsEmpty(queue)) {
-        return NULL;
-    }
+static void defaultFree(void* context, void* pointer) {
+    (void)context;
+    free(pointer);
+}
 
-    // highest_priority is first set to the priority of the first element in "list_of_element"
-    PQElementPriority highest_priority = queue->list_of_elements[0].priority; 
+static const PQAllocator default_allocator = { defaultAlloc, defaultRealloc, defaultFree, NULL };
 
-    for(int index = 1; index < queue->size; index++) {
-        PQElementPriority current_element_priority = queue->list_of_elements[index].priority;
+// Returns the allocator of queues that weren't given one
+const PQAllocator* pqDefaultAllocator(void) {
+    return &default_allocator;
+}
 
-        // the compare_priorities function returns a positive number if 
-        // current_element_priority is greater than highest_priority
-        if(queue->compare_priorities(current_element_priority, highest_priority) > 0) {
-            highest_priority = current_element_priority;
-        }
+// allocates size bytes with the queue's allocator
+static void* queueMalloc(const PriorityQueue queue, size_t size) {
+    return queue->allocator.alloc(queue->allocator.context, size);
+}
+
+// reallocates pointer to size bytes with the queue's allocator
+static void* queueRealloc(const PriorityQueue queue, void* pointer, size_t size) {
+    return queue->allocator.realloc(queue->allocator.context, pointer, size);
+}
+
+// frees pointer (if it isn't NULL) with the given allocator
+static void allocatorFree(const PQAllocator* allocator, void* pointer) {
+    if(pointer != NULL) {
+        allocator->free(allocator->context, pointer);
     }
-    // at the end of this for loop, highest_priority will be set to the highest priority in "list_of_elements"
+}
 
-    return highest_priority;
+// frees pointer (if it isn't NULL) with the queue's allocator
+static void queueFree(const PriorityQueue queue, void* pointer) {
+    allocatorFree(&queue->allocator, pointer);
 }
 
-// Returns the index of the highest priority element in the "list_of_elements".
-// If there are multiple elements with the high priority, than return the first one in "list_of_elements"
-// Note: if the queue is empty, than return ELEMENT_NOT_FOUND
-static int findHighestPriorityElementIndex(const PriorityQueue queue) {
-    assert(queue != NULL);
 
-    // gets the highest priority in queue
-    PQElementPriority highest_priority = findHighestPriorityInQueue(queue); 
-    if(highest_priority == NULL) {
-        return ELEMENT_NOT_FOUND;
-    }
+/*----------------------------------------------------------------------
+                     Element index (hashed queues only)
+ ----------------------------------------------------------------------*/
 
-    for(int index = 0; index < queue->size; index++) {
-        // the compare_priorities() func returns 0 when the two inputted priorities are equal
-        if(queue->compare_priorities(queue->list_of_elements[index].priority, highest_priority) == 0) {
-            return index;
+// returns true if queue was created with a hash function, and keeps an element index
+static bool isHashed(const PriorityQueue queue) {
+    return queue->hash_element != NULL;
+}
+
+// returns the bucket in element_index where the search for a hash begins
+static int homeBucket(const PriorityQueue queue, unsigned long hash) {
+    return (int)(hash & (unsigned long)(queue->index_size - 1));
+}
+
+// returns the index in element_index of the bucket of element, or ELEMENT_NOT_FOUND if
+// no element in the queue is equal to element
+static int findBucket(const PriorityQueue queue, PQElement element, unsigned long hash) {
+    for(int bucket = homeBucket(queue, hash);
+        queue->element_index[bucket].first_element != ELEMENT_NOT_FOUND;
+        bucket = (bucket + 1) & (queue->index_size - 1)) {
+        ElementBucket* current = &queue->element_index[bucket];
+        if(current->hash == hash &&
+           queue->compare_elements(queue->list_of_elements[current->first_element].element, element)) {
+            return bucket;
         }
     }
-
     return ELEMENT_NOT_FOUND;
 }
 
-// sets the iterator to be in an undefined state
-static void clearIterator(PriorityQueue queue) {
-    if(queue == NULL) {
-        return;
-    }
-    for(int index = 0; index < queue->size; index++) {
-        queue->list_of_elements[index].used = false;
+// returns the index in element_index of the empty bucket where a new bucket with hash should be put
+static int findEmptyBucket(const PriorityQueue queue, unsigned long hash) {
+    int bucket = homeBucket(queue, hash);
+    while(queue->element_index[bucket].first_element != ELEMENT_NOT_FOUND) {
+        bucket = (bucket + 1) & (queue->index_size - 1);
     }
+    return bucket;
 }
 
-// takes into account used (aka iterator)
-// returns NULL if queue is empty or if iterator has already iterated over all of the elements in queue
-static PQElementPriority getNextHighestPriority(const PriorityQueue queue) {
-    assert(queue != NULL);
-
-    // queue is empty, therefore there is no element with 
-    // highest priority because there are no elements in queue
-    if(pqIsEmpty(queue)) {
+// allocates an element index with index_size empty buckets
+static ElementBucket* createElementIndex(const PriorityQueue queue, int index_size) {
+    ElementBucket* element_index = queueMalloc(queue, index_size * sizeof(ElementBucket));
+    if(element_index == NULL) {
         return NULL;
     }
-
-    PQElementPriority highest_priority = NULL;
-    for(int i = 0; i < queue->size; i++) {
-        if(queue->list_of_elements[i].used == false) {
-            highest_priority = queue->list_of_elements[i].priority;
-            // printf("in getting highest priority: %d\n", queue->list_of_elements[i].used);
-            break;
-        }
+    for(int bucket = 0; bucket < index_size; bucket++) {
+        element_index[bucket].first_element = ELEMENT_NOT_FOUND;
+        element_index[bucket].count = 0;
     }
+    return element_index;
+}
 
-    // the iterator has iterated over all of the elements in the queue
-    if(highest_priority == NULL) {
-        return NULL;
+/**
+ * @brief makes sure that count more buckets can be added to the element index,
+ *        doubling the number of buckets (as many times as needed, rehashing once) when the index is too full
+ *
+ * @return PriorityQueueResult :
+ *         PQ_SUCCESS if there is room for count more buckets
+ *         PQ_OUT_OF_MEMORY if there was not enough memory
+ */
+static PriorityQueueResult ensureIndexRoom(PriorityQueue queue, int count) {
+    assert(isHashed(queue));
+    int new_size = queue->index_size;
+    while((queue->index_used + count) * INDEX_LOAD_FACTOR > new_size) {
+        new_size *= 2;
+    }
+    if(new_size == queue->index_size) {
+        return PQ_SUCCESS;
     }
 
-    for(int index = 0; index < queue->size; index++) {
-        //if the iterator already looked at this element in list_of_elements
-        if(queue->list_of_elements[index].used == true) {
-            continue;
-        }
-
-        PQElementPriority current_element_priority = queue->list_of_elements[index].priority;
+    ElementBucket* old_index = queue->element_index;
+    int old_size = queue->index_size;
+    ElementBucket* new_index = createElementIndex(queue, new_size);
+    if(new_index == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
 
-        // the compare_priorities function returns a positive number if 
-        // current_element_priority is greater than highest_priority
-        if(queue->compare_priorities(current_element_priority, highest_priority) > 0) {
-            highest_priority = current_element_priority;
+    // moves every bucket to its place in the new index, using the stored hashes
+    queue->element_index = new_index;
+    queue->index_size = new_size;
+    for(int bucket = 0; bucket < old_size; bucket++) {
+        if(old_index[bucket].first_element != ELEMENT_NOT_FOUND) {
+            queue->element_index[findEmptyBucket(queue, old_index[bucket].hash)] = old_index[bucket];
         }
     }
-    // at the end of this for loop, highest_priority will be set to the highest priority in "list_of_elements"
+    queueFree(queue, old_index);
 
-    return highest_priority;
+    return PQ_SUCCESS;
 }
 
-// returns the index in "list_of_elements" of the next highest priority element
-// NOTE: takes into account what the iterator has already looked at, aka used = true;
-static int getNextHighestPriorityElementIndex(PriorityQueue queue) {
-    assert(queue != NULL);
-
-    // gets the highest priority in queue
-    PQElementPriority highest_priority = getNextHighestPriority(queue); 
-
-    // if highest_priority = NULL, than the iteator has iterated over all of the elements in queue
-    if(highest_priority == NULL) {
-        return ELEMENT_NOT_FOUND;
+// adds the Element with the given index in list_of_elements to the element index
+// NOTE: ensureIndexRoom must have been called before
+static void indexAddElement(PriorityQueue queue, int element_index) {
+    Element* added = &queue->list_of_elements[element_index];
+    unsigned long hash = queue->hash_element(added->element);
+    added->previous_equal = ELEMENT_NOT_FOUND;
+
+    int bucket = findBucket(queue, added->element, hash);
+    if(bucket == ELEMENT_NOT_FOUND) {
+        // first Element with this element, a new bucket is needed
+        bucket = findEmptyBucket(queue, hash);
+        queue->element_index[bucket].hash = hash;
+        queue->element_index[bucket].count = 0;
+        queue->index_used++;
+        added->next_equal = ELEMENT_NOT_FOUND;
+    } else {
+        // the Element is linked in front of the other equal Elements
+        added->next_equal = queue->element_index[bucket].first_element;
+        queue->list_of_elements[added->next_equal].previous_equal = element_index;
     }
+    queue->element_index[bucket].first_element = element_index;
+    queue->element_index[bucket].count++;
+}
 
-    for(int index = 0; index < queue->size; index++) {
-        //if the iterator has already looked into this element in list_of_elements
-        if(queue->list_of_elements[index].used == true) {
-            continue;
-        }
-
-        // the compare_priorities() func returns 0 when the two inputted priorities are equal
-        if(queue->compare_priorities(queue->list_of_elements[index].priority, highest_priority) == 0) {
-            return index;
+// empties the bucket at index "bucket" in the element index, moving back the buckets after it so that
+// every bucket can still be found by linear probing from its home bucket
+static void removeBucket(PriorityQueue queue, int bucket) {
+    int mask = queue->index_size - 1;
+    int hole = bucket;
+    for(int current = (hole + 1) & mask;
+        queue->element_index[current].first_element != ELEMENT_NOT_FOUND;
+        current = (current + 1) & mask) {
+        // a bucket can fill the hole if the hole is between its home bucket and its current place
+        int home = homeBucket(queue, queue->element_index[current].hash);
+        if(((current - home) & mask) >= ((current - hole) & mask)) {
+            queue->element_index[hole] = queue->element_index[current];
+            hole = current;
         }
     }
-
-    return ELEMENT_NOT_FOUND;   
+    queue->element_index[hole].first_element = ELEMENT_NOT_FOUND;
+    queue->element_index[hole].count = 0;
+    queue->index_used--;
 }
 
-/**
- * @brief expands the queue's internal array (list_of_elements) so it can store more elements
- * 
- * @return PriorityQueueResult :
- *         PQ_SUCCESS if the expansion was succesful
- *         PQ_OUT_OF_MEMORY if there was not enough memory
- */
-static PriorityQueueResult expand(PriorityQueue queue) {
-    assert(queue != NULL);
-
-    // the new max size of the queue
-    int new_size = queue->max_size * EXPAND_RATE;
-
-    // reallocated the old list_of_elements with size of new_size
-    Element* new_list_of_elements = realloc(queue->list_of_elements, new_size * sizeof(Element));
-    if(new_list_of_elements == NULL) {
-        return PQ_OUT_OF_MEMORY;
+// removes the Element with the given index in list_of_elements from the element index
+// NOTE: must be called while the Element still holds its element
+static void indexRemoveElement(PriorityQueue queue, int element_index) {
+    Element* removed = &queue->list_of_elements[element_index];
+    int bucket = findBucket(queue, removed->element, queue->hash_element(removed->element));
+    assert(bucket != ELEMENT_NOT_FOUND);
+
+    // unlinks the Element from the other equal Elements
+    if(removed->previous_equal != ELEMENT_NOT_FOUND) {
+        queue->list_of_elements[removed->previous_equal].next_equal = removed->next_equal;
+    } else {
+        queue->element_index[bucket].first_element = removed->next_equal;
+    }
+    if(removed->next_equal != ELEMENT_NOT_FOUND) {
+        queue->list_of_elements[removed->next_equal].previous_equal = removed->previous_equal;
     }
 
-    // if successful then change the old list_of_elements to the new list
-    queue->list_of_elements = new_list_of_elements;
-    queue->max_size = new_size;
-
-    return PQ_SUCCESS;
+    queue->element_index[bucket].count--;
+    if(queue->element_index[bucket].count == 0) {
+        removeBucket(queue, bucket);
+    }
 }
 
-// moves all of the elements in queue's list_of_elements array left in the index spot
-// helper func used in pqChangePriority( ... )
-static void moveElementsLeft(PriorityQueue queue, int index) {
-    for(int i = index; i < queue->size-1; i++) {
-        queue->list_of_elements[i] = queue->list_of_elements[i+1];
+// points the links to the Element with index "from" in list_of_elements (from its bucket or the Elements
+// equal to it) at index "to" instead
+// NOTE: must be called while the Element with index "from" still holds its element
+static void indexMoveElement(PriorityQueue queue, int from, int to) {
+    Element* moved = &queue->list_of_elements[from];
+    if(moved->previous_equal != ELEMENT_NOT_FOUND) {
+        queue->list_of_elements[moved->previous_equal].next_equal = to;
+    } else {
+        int bucket = findBucket(queue, moved->element, queue->hash_element(moved->element));
+        assert(bucket != ELEMENT_NOT_FOUND);
+        queue->element_index[bucket].first_element = to;
+    }
+    if(moved->next_equal != ELEMENT_NOT_FOUND) {
+        queue->list_of_elements[moved->next_equal].previous_equal = to;
     }
 }
 
-// the "iterator" is defined when pqGetFirst has been called.
-// this means that if pqGetFirst has been called, 
-// than atleast one element in "list_of_elements" has been used (used = true)
-static bool iteratorIsDefined(PriorityQueue queue) {
-    if(pqIsEmpty(queue)) return false;
-    for(int i = 0; i < queue->size; i++) {
-        if(queue->list_of_elements[i].used == true) {
-            return true;
-        }
+// returns the index in list_of_elements of the first of the Elements equal to element,
+// or ELEMENT_NOT_FOUND if there are none. the rest of them are found through next_equal
+static int firstEqualElement(const PriorityQueue queue, PQElement element) {
+    int bucket = findBucket(queue, element, queue->hash_element(element));
+    if(bucket == ELEMENT_NOT_FOUND) {
+        return ELEMENT_NOT_FOUND;
     }
-    return false;
+    return queue->element_index[bucket].first_element;
 }
 
 
 /*----------------------------------------------------------------------
-                             Creation functions
+                             Static helper functions
  ----------------------------------------------------------------------*/
 
-// Allocates a new empty priority queue
-PriorityQueue pqCreate(CopyPQElement copy_element,
-                       FreePQElement free_element,
-                       EqualPQElements equal_elements,
-                       CopyPQElementPriority copy_priority,
-                       FreePQElementPriority free_priority,
-                       ComparePQElementPriorities compare_priorities) {
-    // check for NULL parameters
-    if(copy_element == NULL || free_element == NULL || equal_elements == NULL || 
-    copy_priority == NULL || free_priority == NULL || compare_priorities == NULL) {
-        return NULL;
+// returns true if queue stores its elements and priorities by value (see pqCreateInline)
+static bool isInline(const PriorityQueue queue) {
+    return queue->element_size > 0;
+}
+
+// points the Elements of an inline queue at their values in element_storage and priority_storage
+// helper func used after the storage arrays were (re)allocated
+static void rebaseInlineStorage(PriorityQueue queue) {
+    for(int position = 0; position < queue->size; position++) {
+        int element_index = queue->heap[position];
+        queue->list_of_elements[element_index].element =
+                queue->element_storage + (size_t)element_index * queue->element_size;
+        queue->list_of_elements[element_index].priority =
+                queue->priority_storage + (size_t)element_index * queue->priority_size;
+        queue->heap_keys[position].priority = queue->list_of_elements[element_index].priority;
     }
+}
 
-    // allocate space for the queue
-    PriorityQueue queue = malloc (sizeof(*queue));
-    if (queue == NULL) {
-        return NULL;
+// frees an element that belonged to the queue (an inline queue has nothing to free)
+static void freeQueueElement(const PriorityQueue queue, PQElement element) {
+    if(!isInline(queue)) {
+        queue->free_element(element);
     }
+}
 
-    // allocate space for the list_of_elements, using the initial size defined
-    queue->list_of_elements = malloc(INITIAL_SIZE * sizeof(Element));
-    if(queue->list_of_elements == NULL) {
-        free(queue);
-        return NULL;
+// frees a priority that belonged to the queue (an inline queue has nothing to free)
+static void freeQueuePriority(const PriorityQueue queue, PQElementPriority priority) {
+    if(!isInline(queue)) {
+        queue->free_priority(priority);
     }
- 
-    // the size of the queue when first created is 0
-    queue->size = 0;
-    queue->max_size = INITIAL_SIZE;
-    
-    // use the funcs given by the user
-    queue->copy_element = copy_element;
-    queue->free_element = free_element;
-    queue->compare_elements = equal_elements;
-    queue->copy_priority = copy_priority;
-    queue->free_priority = free_priority;
-    queue->compare_priorities = compare_priorities;
+}
 
-    return queue;
+// returns true if queue is empty, false otherwise
+// Note: an empty queue means that the "heap" in queue is of size 0.
+//      (the number of elements in "heap" is equal to the "size" field in PriorityQueue_t)
+static bool pqIsEmpty(const PriorityQueue queue) {
+    assert(queue != NULL);
+    if(queue->size == 0) return true;
+    else return false;
 }
 
-// Deallocates an existing priority queue. Clears all elements by using the free functions
-void pqDestroy (PriorityQueue queue) {
-    if(queue == NULL) {
-        return;
+// returns the Element that sits at the given position of the heap
+static Element* elementAtPosition(const PriorityQueue queue, int position) {
+    assert(queue != NULL && position >= 0 && position < queue->size);
+    return &queue->list_of_elements[queue->heap[position]];
+}
+
+// returns true if the first Element should leave the queue before the second one, by their heap keys.
+// the Element with the higher priority comes first, and between two
+// equal priorities the Element that was inserted first comes first
+static bool keyComesFirst(const PriorityQueue queue, const HeapKey* first, const HeapKey* second) {
+    int compare_result = queue->compare_priorities(first->priority, second->priority);
+    if(compare_result != 0) {
+        return compare_result > 0;
     }
+    return first->sequence < second->sequence;
+}
 
-    // clears the iterator 
-    clearIterator(queue);
+// the compare functions of queues with primitive priorities: the higher value has the higher priority
+static int compareInt32Priorities(PQElementPriority first, PQElementPriority second) {
+    int32_t first_value = *(int32_t*)first;
+    int32_t second_value = *(int32_t*)second;
+    return (first_value > second_value) - (first_value < second_value);
+}
 
-    // first free the elements inside of the "list_of_elements" 
-    while(!pqIsEmpty(queue)) {
-        pqRemove(queue);
-    }
-    
-    // first frees the list of elements array, and then the queue itself
-    free(queue->list_of_elements);
-    free(queue);
+static int compareFloatPriorities(PQElementPriority first, PQElementPriority second) {
+    float first_value = *(float*)first;
+    float second_value = *(float*)second;
+    return (first_value > second_value) - (first_value < second_value);
+}
 
-    // set queue to NULL so that user knows queue is now deallocated and not for use
-    queue = NULL;
+static int compareDoublePriorities(PQElementPriority first, PQElementPriority second) {
+    double first_value = *(double*)first;
+    double second_value = *(double*)second;
+    return (first_value > second_value) - (first_value < second_value);
 }
 
-// Creates a copy of target priority queue.
-// Iterator values for both priority queues are undefined after this operation.
-PriorityQueue pqCopy(PriorityQueue queue) {
-    if(queue == NULL) {
-        return NULL;
+// returns the number of bytes of a priority of type, 0 for PQ_PRIORITY_CUSTOM
+static int priorityTypeSize(PQPriorityType type) {
+    switch(type) {
+        case PQ_PRIORITY_INT32:
+            return sizeof(int32_t);
+        case PQ_PRIORITY_FLOAT:
+            return sizeof(float);
+        case PQ_PRIORITY_DOUBLE:
+            return sizeof(double);
+        default:
+            return 0;
     }
+}
 
-    // allocate space for a new queue
-    PriorityQueue new_queue = malloc(sizeof(*new_queue));
-    if(new_queue == NULL) {
-        return NULL;
+// compares two values of the priority type of a queue with primitive priorities, like compare_priorities
+static int comparePrimitiveValues(const PriorityQueue queue, PQElementPriority first, PQElementPriority second) {
+    switch(queue->priority_type) {
+        case PQ_PRIORITY_INT32:
+            return compareInt32Priorities(first, second);
+        case PQ_PRIORITY_FLOAT:
+            return compareFloatPriorities(first, second);
+        default:
+            return compareDoublePriorities(first, second);
     }
+}
 
-    // create space for the list of elements array
-    new_queue->list_of_elements = malloc(queue->max_size * sizeof(Element));
-    if(new_queue->list_of_elements == NULL) {
-        free(new_queue);
-        return NULL;
+// returns the value of the priority of the Element at position, in a queue with primitive priorities
+static PQElementPriority valueAtPosition(const PriorityQueue queue, int position) {
+    return queue->heap_values + (size_t)position * queue->value_size;
+}
+
+// same as keyComesFirst, for the Elements at two positions of the heap.
+// primitive priorities are compared by their values in heap_values, without calling compare_priorities
+static bool positionComesFirst(const PriorityQueue queue, int first_position, int second_position) {
+    if(queue->heap_values != NULL) {
+        int compare_result = comparePrimitiveValues(queue, valueAtPosition(queue, first_position),
+                                                     valueAtPosition(queue, second_position));
+        if(compare_result != 0) {
+            return compare_result > 0;
+        }
+        return queue->heap_keys[first_position].sequence < queue->heap_keys[second_position].sequence;
     }
+    return keyComesFirst(queue, &queue->heap_keys[first_position], &queue->heap_keys[second_position]);
+}
 
-    // set the size of new_queue to be the same as queue from user
-    new_queue->max_size = queue->max_size;
+// copies the priority and sequence of the Element at position into heap_keys
+// helper func called whenever they change while the Element stays in place
+static void refreshHeapKey(PriorityQueue queue, int position) {
+    const Element* current = &queue->list_of_elements[queue->heap[position]];
+    queue->heap_keys[position].priority = current->priority;
+    queue->heap_keys[position].sequence = current->sequence;
+    if(queue->heap_values != NULL) {
+        memcpy(valueAtPosition(queue, position), current->priority, queue->value_size);
+    }
+}
 
-    // size of new_queue should be 0 because we are going to be inserting elements into it one by one, 
-    // which will increase its size
-    new_queue->size = 0;
+// puts the Element with the given index in list_of_elements at position in the heap
+static void placeElement(PriorityQueue queue, int element_index, int position) {
+    queue->heap[position] = element_index;
+    queue->list_of_elements[element_index].position = position;
+    refreshHeapKey(queue, position);
+}
 
-    // set the funcs from the user's queue to be in the new_queue
-    new_queue->copy_element = queue->copy_element;
-    new_queue->free_element = queue->free_element;
-    new_queue->compare_elements = queue->compare_elements;
-    new_queue->copy_priority = queue->copy_priority;
-    new_queue->free_priority = queue->free_priority;
-    new_queue->compare_priorities = queue->compare_priorities;
+// swaps the Elements at position1 and position2 of the heap
+static void swapPositions(PriorityQueue queue, int position1, int position2) {
+    int temp = queue->heap[position1];
+    placeElement(queue, queue->heap[position2], position1);
+    placeElement(queue, temp, position2);
+}
 
-    // insert each element/priority from the user's queue into the new_queue
-    for(int i = 0; i < queue->size; i++) {
-        // make sure that the insertion was succesful 
-        PQElement queue_element = queue->list_of_elements[i].element;
-        PQElementPriority queue_element_priority = queue->list_of_elements[i].priority;
-        if(pqInsert(new_queue, queue_element, queue_element_priority) == PQ_OUT_OF_MEMORY) {
-            pqDestroy(new_queue);
-            return NULL;
-        }
+// returns true if position is on a max level of a min-max heap (the root's level is a max level)
+static bool isOnMaxLevel(int position) {
+    int level = 0;
+    for(position++; position > 1; position /= 2) {
+        level++;
     }
+    return level % 2 == 0;
+}
 
-    // set both the queue's and new_queue's iterators to be undefined 
-    clearIterator(queue);
-    clearIterator(new_queue);
+// returns true if the Element at first_position should be above the one at second_position in a min-max heap,
+// on a max level if max_level is true (the one that comes first), or on a min level (the one that comes last)
+static bool positionGoesUp(const PriorityQueue queue, bool max_level, int first_position, int second_position) {
+    return max_level ? positionComesFirst(queue, first_position, second_position) :
+           positionComesFirst(queue, second_position, first_position);
+}
 
-    return new_queue;
+// moves the Element at position of a min-max heap up the levels of its own kind (max_level),
+// by swapping it with its grandparent. returns the final position of the Element
+static int minMaxBubbleUp(PriorityQueue queue, int position, bool max_level) {
+    while(position > 2) {
+        int grandparent = ((position - 1) / 2 - 1) / 2;
+        if(!positionGoesUp(queue, max_level, position, grandparent)) {
+            break;
+        }
+        swapPositions(queue, position, grandparent);
+        position = grandparent;
+    }
+    return position;
 }
 
+// moves the Element at position up a min-max heap: to its parent's place if it belongs on the parent's kind
+// of levels, and then up the levels of that kind. returns the final position of the Element
+// NOTE: if the Element took its parent's place, the parent's Element may have to move down from position
+static int minMaxSiftUp(PriorityQueue queue, int position) {
+    if(position == 0) {
+        return position;
+    }
+    int parent = (position - 1) / 2;
+    bool max_level = isOnMaxLevel(position);
+    if(positionGoesUp(queue, !max_level, position, parent)) {
+        swapPositions(queue, position, parent);
+        return minMaxBubbleUp(queue, parent, !max_level);
+    }
+    return minMaxBubbleUp(queue, position, max_level);
+}
 
+// moves the Element at position down a min-max heap, swapping it with the child or grandchild that should be
+// above all the others (Atkinson et al.), until none of them should be above it
+static void minMaxSiftDown(PriorityQueue queue, int position) {
+    while(true) {
+        int first_child = 2 * position + 1;
+        if(first_child >= queue->size) {
+            break;
+        }
+        bool max_level = isOnMaxLevel(position);
 
-/*----------------------------------------------------------------------
-                              Queue operations
- ----------------------------------------------------------------------*/
+        // the best of the (up to) two children and four grandchildren
+        int best = first_child;
+        if(first_child + 1 < queue->size && positionGoesUp(queue, max_level, first_child + 1, best)) {
+            best = first_child + 1;
+        }
+        for(int grandchild = 2 * first_child + 1; grandchild <= 2 * first_child + 4 &&
+                                                  grandchild < queue->size; grandchild++) {
+            if(positionGoesUp(queue, max_level, grandchild, best)) {
+                best = grandchild;
+            }
+        }
 
-// Returns the number of elements in a priority queue
-int pqGetSize(PriorityQueue queue) {
-    if(queue == NULL) {
-        return -1;
+        if(!positionGoesUp(queue, max_level, best, position)) {
+            break;
+        }
+        swapPositions(queue, position, best);
+        if(best <= first_child + 1) {
+            // a child has no descendants the Element could be out of order with
+            break;
+        }
+
+        // the Element moved two levels down, past a parent of the other kind that it may belong above
+        int parent = (best - 1) / 2;
+        if(positionGoesUp(queue, !max_level, best, parent)) {
+            swapPositions(queue, best, parent);
+        }
+        position = best;
     }
-    return queue->size;
 }
 
-// Checks if an element exists in the priority queue. The element will be
-// considered in the priority queue if one of the elements in the priority queue it determined equal
-// using the comparison function used to initialize the priority queue.
-bool pqContains(PriorityQueue queue, PQElement element) {
-    if(queue == NULL || element == NULL) {
-        return NULL;
+// moves the Element at position up the heap until its parent comes before it
+// returns the final position of the Element
+static int siftUp(PriorityQueue queue, int position) {
+    assert(queue != NULL);
+    if(queue->double_ended) {
+        return minMaxSiftUp(queue, position);
     }
-
-    // goes through the list_of_elements array to check for a matching element 
-    for(int i = 0; i < queue->size; i++) {
-        if(queue->compare_elements(queue->list_of_elements[i].element, element)) {
-            return true; //matching element found
+    while(position > 0) {
+        int parent = (position - 1) / queue->arity;
+        if(!positionComesFirst(queue, position, parent)) {
+            break;
         }
+        swapPositions(queue, position, parent);
+        position = parent;
     }
+    return position;
+}
 
-    return false; //element was not found
+// returns the child that comes first out of the count children from first_child on, in a queue with
+// primitive priorities: the kernels find the children with the highest value, and their sequences decide
+// between them
+static int bestChildByValue(const PriorityQueue queue, int first_child, int count) {
+    unsigned highest = queue->kernels->maximumMask(valueAtPosition(queue, first_child), count);
+    int best_child = ELEMENT_NOT_FOUND;
+    for(int child = first_child; highest != 0; child++, highest >>= 1) {
+        if((highest & 1) && (best_child == ELEMENT_NOT_FOUND ||
+                             queue->heap_keys[child].sequence < queue->heap_keys[best_child].sequence)) {
+            best_child = child;
+        }
+    }
+    return best_child;
 }
 
-// Add a specified element with a specific priority.
-// NOTE: Iterator's value is undefined after this operation.
-PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPriority priority) {
-    if(queue == NULL || element == NULL || priority == NULL) {
-        return PQ_NULL_ARGUMENT;
+// moves the Element at position down the heap until it comes before all of its children
+static void siftDown(PriorityQueue queue, int position) {
+    assert(queue != NULL);
+    if(queue->double_ended) {
+        minMaxSiftDown(queue, position);
+        return;
     }
+    while(true) {
+        int first_child = queue->arity * position + 1;
+        if(first_child >= queue->size) {
+            break;
+        }
 
-    // the list_of_elements array has reached its max size, therefore we need to expand its size
-    if(queue->size == queue->max_size) {
-        if(expand(queue) == PQ_OUT_OF_MEMORY) {
-            return PQ_OUT_OF_MEMORY;
+        // the child that comes first out of the (up to) arity children. their keys are contiguous in heap_keys
+        int last_child = first_child + queue->arity - 1 < queue->size ? first_child + queue->arity - 1 :
+                         queue->size - 1;
+        int best_child = first_child;
+        if(queue->kernels != NULL && queue->arity > DEFAULT_ARITY) {
+            best_child = bestChildByValue(queue, first_child, last_child - first_child + 1);
+        } else {
+            for(int child = first_child + 1; child <= last_child; child++) {
+                if(positionComesFirst(queue, child, best_child)) {
+                    best_child = child;
+                }
+            }
         }
-    }
 
-    // the index of the element that wants to be inserted into the queue
-    int current_element_index = queue->size;
+        if(!positionComesFirst(queue, best_child, position)) {
+            break;
+        }
+        swapPositions(queue, position, best_child);
+        position = best_child;
+    }
+}
 
-    // allocated the memory for the Element in list_of_elements in queue
-    // also copies the inputted element and priority into the Element in list_of_elements
-    queue->list_of_elements[current_element_index].element = queue->copy_element(element);
-    if(queue->list_of_elements[current_element_index].element == NULL) {
-        queue->free_element(queue->list_of_elements[current_element_index].element);
-        return PQ_OUT_OF_MEMORY;
+// moves the Element at position up or down the heap, whichever restores the heap order
+static void restoreHeapAt(PriorityQueue queue, int position) {
+    if(queue->double_ended) {
+        // the Element that is left at position (itself, or one that moved down to it) may belong lower
+        minMaxSiftUp(queue, position);
+        minMaxSiftDown(queue, position);
+        return;
     }
-    queue->list_of_elements[current_element_index].priority = queue->copy_priority(priority);
-    if(queue->list_of_elements[current_element_index].priority == NULL) {
-        queue->free_element(queue->list_of_elements[current_element_index].element);
-        queue->free_priority(queue->list_of_elements[current_element_index].priority);
-        return PQ_OUT_OF_MEMORY;
+    if(siftUp(queue, position) == position) {
+        siftDown(queue, position);
     }
+}
 
-    queue->list_of_elements[current_element_index].used = false;
+// returns the position of the Element that comes last in the queue (the one with the lowest priority).
+// in a min-max heap it is one of the root's children, otherwise one of the leaves of the heap
+// NOTE: the queue must not be empty
+static int lastPosition(const PriorityQueue queue) {
+    assert(!pqIsEmpty(queue));
+    if(queue->size == 1) {
+        return 0;
+    }
+    int first_candidate = queue->double_ended ? 1 : (queue->size - 2) / queue->arity + 1;
+    int end = queue->double_ended && queue->size > 3 ? 3 : queue->size;
+    int last = first_candidate;
+    for(int position = first_candidate + 1; position < end; position++) {
+        if(positionComesFirst(queue, last, position)) {
+            last = position;
+        }
+    }
+    return last;
+}
 
-    // queue's size increased by 1
-    queue->size++;
+// takes an unused Element out of list_of_elements and returns its index
+// NOTE: there must be room in the queue (size < max_size)
+static int takeFreeElement(PriorityQueue queue) {
+    assert(queue != NULL && queue->first_free_element != ELEMENT_NOT_FOUND);
+    int element_index = queue->first_free_element;
+    queue->first_free_element = queue->list_of_elements[element_index].position;
+    return element_index;
+}
 
-    // queue's iterator is undefined after insert
-    clearIterator(queue);
+// returns the Element with the given index in list_of_elements to the unused Elements
+static void releaseElement(PriorityQueue queue, int element_index) {
+    queue->list_of_elements[element_index].position = queue->first_free_element;
+    queue->first_free_element = element_index;
+}
 
-    return PQ_SUCCESS;
+// links the Elements in list_of_elements from index "from" up to (not including) "to"
+// in front of the list of unused Elements
+static void addFreeElements(PriorityQueue queue, int from, int to) {
+    for(int element_index = to - 1; element_index >= from; element_index--) {
+        releaseElement(queue, element_index);
+    }
 }
 
-// Changes the priority of specific element with a specific priority in the priority queue.
-// See header file for important note.
-PriorityQueueResult pqChangePriority(PriorityQueue queue, PQElement element,
-                                        PQElementPriority old_priority, PQElementPriority new_priority) {
-    if(queue == NULL || element == NULL || old_priority == NULL || new_priority == NULL) {
-        return PQ_NULL_ARGUMENT;
-    }    
+// takes the Element at position out of the heap (without freeing its contents) and restores the heap order
+// helper func used in pqRemove and pqRemoveElement
+// NOTE: must be called before the contents of the Element are freed
+static void removeElementAtPosition(PriorityQueue queue, int position) {
+    assert(queue != NULL && position >= 0 && position < queue->size);
 
-    // first looks for the element in the queue's list_of_elements
-    bool element_found = false;
-    for(int i = 0; i < queue->size; i++) {
-        // compares both the element and the priority
-        if(queue->compare_elements(queue->list_of_elements[i].element, element)) {
-            if(queue->compare_priorities(queue->list_of_elements[i].priority, old_priority) == 0) {
-                element_found = true;
-
-                // the element has been found:
-                // free element and priority in Element
-                queue->free_element(queue->list_of_elements[i].element); 
-                queue->free_priority(queue->list_of_elements[i].priority);
-                moveElementsLeft(queue, i);
-
-                queue->size--;
-                break;
-            }
-        }
+    if(isHashed(queue)) {
+        indexRemoveElement(queue, queue->heap[position]);
     }
+    releaseElement(queue, queue->heap[position]);
 
-    if(!element_found) {
-        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    // the last Element fills the hole, and is then moved to its correct place
+    queue->size--;
+    if(position == queue->size) {
+        return;
     }
+    placeElement(queue, queue->heap[queue->size], position);
+    restoreHeapAt(queue, position);
+}
 
-    // insert the element with the new priority
-    pqInsert(queue, element, new_priority);
+// frees the elements (or priorities, if priorities is true) of all the Elements in the queue, in a single
+// sweep over the heap. uses the batch free func if there is one (falling back to the free func if the
+// array for it can't be allocated)
+static void freeAllContents(PriorityQueue queue, bool priorities) {
+    FreePQElementBatch free_batch = priorities ? queue->free_priority_batch : queue->free_element_batch;
+    PQElement* contents = free_batch == NULL ? NULL : queueMalloc(queue, queue->size * sizeof(PQElement));
+    for(int position = 0; position < queue->size; position++) {
+        Element* current = elementAtPosition(queue, position);
+        PQElement content = priorities ? current->priority : current->element;
+        if(contents != NULL) {
+            contents[position] = content;
+        } else if(priorities) {
+            queue->free_priority(content);
+        } else {
+            queue->free_element(content);
+        }
+    }
+    if(contents != NULL) {
+        free_batch(contents, queue->size);
+        queueFree(queue, contents);
+    }
+}
 
-    // the iterator is undefined after changing the priority
-    clearIterator(queue);
-    return PQ_SUCCESS;
+// makes all the Elements of the queue unused and empties its element index, without freeing what they hold
+// (which is either freed or owned by another queue). the queue is left empty
+// NOTE: the storage of the queue must not be shared
+static void forgetAllElements(PriorityQueue queue) {
+    assert(queue->shared_references == NULL);
+    queue->size = 0;
 
+    queue->first_free_element = ELEMENT_NOT_FOUND;
+    addFreeElements(queue, 0, queue->max_size);
+    for(int bucket = 0; isHashed(queue) && bucket < queue->index_size; bucket++) {
+        queue->element_index[bucket].first_element = ELEMENT_NOT_FOUND;
+        queue->element_index[bucket].count = 0;
+    }
+    queue->index_used = 0;
 }
 
-// Removes the highest priority element from the priority queue.
-// see header file for important notes.
+// removes all the elements from the queue and frees them, in O(size + max_size) instead of removing them
+// one by one. the queue is left empty, with all its Elements unused and an empty element index
+// NOTE: the storage of the queue must not be shared
+static void removeAllElements(PriorityQueue queue) {
+    assert(queue->shared_references == NULL);
+    if(!isInline(queue)) {
+        freeAllContents(queue, false);
+        freeAllContents(queue, true);
+    }
+    forgetAllElements(queue);
+}
+
+// sets the internal iterator to be in an undefined state
+static void clearIterator(PriorityQueue queue) {
+    if(queue == NULL) {
+        return;
+    }
+    queue->internal_iterator.defined = false;
+    queue->internal_iterator.frontier_size = 0;
+}
+
+// marks queue as changed, which makes the internal iterator and all PQIterators of queue undefined
+static void markQueueChanged(PriorityQueue queue) {
+    queue->version++;
+}
+
+// returns true if the iteration began, and queue didn't change since
+static bool iteratorIsDefined(const struct PQIterator_t* iterator) {
+    return iterator->defined && iterator->version == iterator->queue->version;
+}
+
+// adds a position of the heap to the iterator's frontier
+static void frontierPush(struct PQIterator_t* iterator, int position) {
+    int* frontier = iterator->frontier;
+    int index = iterator->frontier_size++;
+    while(index > 0) {
+        int parent = (index - 1) / 2;
+        if(!positionComesFirst(iterator->queue, position, frontier[parent])) {
+            break;
+        }
+        frontier[index] = frontier[parent];
+        index = parent;
+    }
+    frontier[index] = position;
+}
+
+// takes the first position out of the iterator's frontier and returns it
+static int frontierPop(struct PQIterator_t* iterator) {
+    assert(iterator->frontier_size > 0);
+    int* frontier = iterator->frontier;
+    int first = frontier[0];
+    int last = frontier[--iterator->frontier_size];
+    int size = iterator->frontier_size;
+
+    int index = 0;
+    while(2 * index + 1 < size) {
+        int child = 2 * index + 1;
+        if(child + 1 < size && positionComesFirst(iterator->queue, frontier[child + 1], frontier[child])) {
+            child++;
+        }
+        if(!positionComesFirst(iterator->queue, frontier[child], last)) {
+            break;
+        }
+        frontier[index] = frontier[child];
+        index = child;
+    }
+    if(size > 0) {
+        frontier[index] = last;
+    }
+    return first;
+}
+
+// sets followers to the positions of the heap that are visited right after position when walking it in order
+// (by an iteration or a search by priority), and returns their number. none of them comes before position,
+// nor do the positions that follow them, and every position but the root follows exactly one position.
+// those are the children, except in a min-max heap: there the children and grandchildren of a position on a
+// max level follow it, and nothing follows a position on a min level (its descendants don't come after it)
+static int followersOf(const PriorityQueue queue, int position, int followers[MAX_FOLLOWERS]) {
+    if(queue->double_ended && !isOnMaxLevel(position)) {
+        return 0;
+    }
+    int count = 0;
+    int first_child = queue->arity * position + 1;
+    for(int child = first_child; child < first_child + queue->arity && child < queue->size; child++) {
+        followers[count++] = child;
+    }
+    if(queue->double_ended) {
+        for(int grandchild = 4 * position + 3; grandchild <= 4 * position + 6 && grandchild < queue->size;
+            grandchild++) {
+            followers[count++] = grandchild;
+        }
+    }
+    return count;
+}
+
+// returns the element at position of the heap, after adding the followers of position to the iterator's
+// frontier. no follower comes before the position it follows, so the first position in the frontier is always
+// the next element by the queue's order
+static PQElement iterateToPosition(struct PQIterator_t* iterator, int position) {
+    PriorityQueue queue = iterator->queue;
+    int followers[MAX_FOLLOWERS];
+    int follower_count = followersOf(queue, position, followers);
+    for(int i = 0; i < follower_count; i++) {
+        frontierPush(iterator, followers[i]);
+    }
+    return elementAtPosition(queue, position)->element;
+}
+
+// begins an iteration from the first element in the queue, and returns it (NULL if the queue is empty)
+// NOTE: the iterator's frontier must have room for the size of the queue
+static PQElement iteratorFirst(struct PQIterator_t* iterator) {
+    PriorityQueue queue = iterator->queue;
+    iterator->defined = true;
+    iterator->version = queue->version;
+    iterator->frontier_size = 0;
+    if(pqIsEmpty(queue)) {
+        return NULL;
+    }
+
+    // the high priority element in the queue is the root of the heap
+    return iterateToPosition(iterator, 0);
+}
+
+// advances the iterator and returns the next element,
+// or NULL if the iterator is undefined or reached the end of the queue
+static PQElement iteratorNext(struct PQIterator_t* iterator) {
+    if(!iteratorIsDefined(iterator) || iterator->frontier_size == 0) {
+        return NULL;
+    }
+
+    // the next element is the first one in the frontier
+    return iterateToPosition(iterator, frontierPop(iterator));
+}
+
+// returns true if the Element with the given index in list_of_elements is in the queue
+// (an unused Element is never pointed at by the used part of the heap)
+static bool elementIsUsed(const PriorityQueue queue, int element_index) {
+    int position = queue->list_of_elements[element_index].position;
+    return position >= 0 && position < queue->size && queue->heap[position] == element_index;
+}
+
+// moves the Element with index "from" in list_of_elements to the unused Element with index "to"
+// helper func used when the queue shrinks, to move Elements out of the part of list_of_elements that is freed
+static void moveElement(PriorityQueue queue, int from, int to) {
+    if(isHashed(queue)) {
+        indexMoveElement(queue, from, to);
+    }
+    queue->list_of_elements[to] = queue->list_of_elements[from];
+    queue->heap[queue->list_of_elements[to].position] = to;
+    if(isInline(queue)) {
+        Element* moved = &queue->list_of_elements[to];
+        moved->element = queue->element_storage + (size_t)to * queue->element_size;
+        moved->priority = queue->priority_storage + (size_t)to * queue->priority_size;
+        memcpy(moved->element, queue->list_of_elements[from].element, queue->element_size);
+        memcpy(moved->priority, queue->list_of_elements[from].priority, queue->priority_size);
+        refreshHeapKey(queue, moved->position);
+    }
+}
+
+// moves every Element in the queue into the first new_size Elements of list_of_elements, and links
+// the unused Elements among them as the free list
+static void compactElements(PriorityQueue queue, int new_size) {
+    assert(new_size >= queue->size);
+    int free_index = 0;
+    for(int position = 0; position < queue->size; position++) {
+        if(queue->heap[position] < new_size) {
+            continue;
+        }
+        while(elementIsUsed(queue, free_index)) {
+            free_index++;
+        }
+        moveElement(queue, queue->heap[position], free_index);
+    }
+
+    queue->first_free_element = ELEMENT_NOT_FOUND;
+    for(int element_index = new_size - 1; element_index >= 0; element_index--) {
+        if(!elementIsUsed(queue, element_index)) {
+            releaseElement(queue, element_index);
+        }
+    }
+}
+
+/**
+ * @brief resizes the queue's internal arrays (list_of_elements, heap, the internal iterator's frontier
+ *        and the storage of an inline queue) so they can store exactly new_size elements.
+ *        when shrinking, the Elements in the queue are first moved into the part that is kept
+ *
+ * @return PriorityQueueResult :
+ *         PQ_SUCCESS if the resize was succesful
+ *         PQ_OUT_OF_MEMORY if there was not enough memory to grow (shrinking always succeeds)
+ */
+static PriorityQueueResult resizeQueue(PriorityQueue queue, int new_size) {
+    assert(queue != NULL && new_size >= queue->size && new_size > 0);
+    bool growing = new_size > queue->max_size;
+
+    // when shrinking, the queue is already usable with new_size before the arrays are reallocated,
+    // and an array that can't be reallocated is kept as it is (it is just bigger than needed)
+    if(new_size < queue->max_size) {
+        compactElements(queue, new_size);
+        queue->max_size = new_size;
+    }
+
+    // reallocated the old list_of_elements with size of new_size
+    Element* new_list_of_elements = queueRealloc(queue, queue->list_of_elements, new_size * sizeof(Element));
+    if(new_list_of_elements == NULL) {
+        return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+    }
+    // if successful then change the old list_of_elements to the new list
+    // (the queue keeps working with the bigger list even if the heap can't grow)
+    queue->list_of_elements = new_list_of_elements;
+
+    int* new_heap = queueRealloc(queue, queue->heap, new_size * sizeof(int));
+    if(new_heap == NULL) {
+        return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+    }
+    queue->heap = new_heap;
+
+    HeapKey* new_heap_keys = queueRealloc(queue, queue->heap_keys, new_size * sizeof(HeapKey));
+    if(new_heap_keys == NULL) {
+        return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+    }
+    queue->heap_keys = new_heap_keys;
+
+    if(queue->heap_values != NULL) {
+        char* new_heap_values = queueRealloc(queue, queue->heap_values, (size_t)new_size * queue->value_size);
+        if(new_heap_values == NULL) {
+            return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+        }
+        queue->heap_values = new_heap_values;
+    }
+
+    int* new_frontier = queueRealloc(queue, queue->internal_iterator.frontier, new_size * sizeof(int));
+    if(new_frontier == NULL) {
+        return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+    }
+    queue->internal_iterator.frontier = new_frontier;
+
+    // an inline queue also needs room for the values of the Elements
+    if(isInline(queue)) {
+        char* new_element_storage = queueRealloc(queue, queue->element_storage,
+                                                 (size_t)new_size * queue->element_size);
+        if(new_element_storage == NULL) {
+            return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+        }
+        queue->element_storage = new_element_storage;
+        rebaseInlineStorage(queue);
+
+        char* new_priority_storage = queueRealloc(queue, queue->priority_storage,
+                                                  (size_t)new_size * queue->priority_size);
+        if(new_priority_storage == NULL) {
+            return growing ? PQ_OUT_OF_MEMORY : PQ_SUCCESS;
+        }
+        queue->priority_storage = new_priority_storage;
+        rebaseInlineStorage(queue);
+    }
+
+    // when growing, the new Elements are all unused
+    if(new_size > queue->max_size) {
+        addFreeElements(queue, queue->max_size, new_size);
+        queue->max_size = new_size;
+    }
+
+    return PQ_SUCCESS;
+}
+
+/**
+ * @brief expands the queue so it can store at least min_size elements.
+ *        the capacity grows by growth_factor as many times as needed, but the arrays are reallocated once
+ *
+ * @return PriorityQueueResult :
+ *         PQ_SUCCESS if the expansion was succesful
+ *         PQ_OUT_OF_MEMORY if there was not enough memory
+ */
+static PriorityQueueResult expand(PriorityQueue queue, int min_size) {
+    assert(queue != NULL && min_size > queue->max_size);
+
+    // the new max size of the queue (a bounded queue never grows past its bound)
+    int new_size = queue->max_size;
+    while(new_size < min_size) {
+        int grown_size = (int)(new_size * queue->growth_factor);
+        new_size = grown_size > new_size ? grown_size : new_size + 1;
+    }
+    if(queue->bound > 0 && new_size > queue->bound) {
+        new_size = queue->bound;
+    }
+
+    return resizeQueue(queue, new_size);
+}
+
+// shrinks the queue once it uses less than shrink_threshold of its capacity (if the queue has a threshold).
+// the new capacity is size * growth_factor (never below the initial capacity), so the queue has to
+// grow back to that size before expanding again, and to drop far below it before shrinking again
+// helper func called by the operations that remove elements
+static void shrinkIfSparse(PriorityQueue queue) {
+    if(queue->shrink_threshold <= 0 || queue->max_size <= queue->min_capacity ||
+       queue->size >= queue->max_size * queue->shrink_threshold) {
+        return;
+    }
+    int new_size = (int)(queue->size * queue->growth_factor);
+    if(new_size < queue->min_capacity) {
+        new_size = queue->min_capacity;
+    }
+    if(new_size < queue->max_size) {
+        resizeQueue(queue, new_size);
+    }
+}
+
+// looks for the Element to change in pqChangePriority: an Element equal to element with a priority equal to
+// priority. if there are multiple matches, the first inserted one is returned.
+// returns the position in the heap of the found Element, or ELEMENT_NOT_FOUND
+static int findElementWithPriority(PriorityQueue queue, PQElement element, PQElementPriority priority) {
+    int found_position = ELEMENT_NOT_FOUND;
+
+    // a hashed queue only looks at the Elements that are equal to element
+    if(isHashed(queue)) {
+        for(int element_index = firstEqualElement(queue, element); element_index != ELEMENT_NOT_FOUND;
+            element_index = queue->list_of_elements[element_index].next_equal) {
+            Element* current = &queue->list_of_elements[element_index];
+            if(queue->compare_priorities(current->priority, priority) == 0) {
+                if(found_position == ELEMENT_NOT_FOUND ||
+                   current->sequence < elementAtPosition(queue, found_position)->sequence) {
+                    found_position = current->position;
+                }
+            }
+        }
+        return found_position;
+    }
+
+    for(int position = 0; position < queue->size; position++) {
+        Element* current = elementAtPosition(queue, position);
+        // compares both the element and the priority
+        if(queue->compare_elements(current->element, element) &&
+           queue->compare_priorities(current->priority, priority) == 0) {
+            if(found_position == ELEMENT_NOT_FOUND ||
+               current->sequence < elementAtPosition(queue, found_position)->sequence) {
+                found_position = position;
+            }
+        }
+    }
+    return found_position;
+}
+
+// looks for the Element to remove in pqRemoveElement: the Element equal to element that would leave the queue first.
+// returns the position in the heap of the found Element, or ELEMENT_NOT_FOUND
+static int findElementToRemove(PriorityQueue queue, PQElement element) {
+    int found_position = ELEMENT_NOT_FOUND;
+
+    // a hashed queue only looks at the Elements that are equal to element
+    if(isHashed(queue)) {
+        for(int element_index = firstEqualElement(queue, element); element_index != ELEMENT_NOT_FOUND;
+            element_index = queue->list_of_elements[element_index].next_equal) {
+            int position = queue->list_of_elements[element_index].position;
+            if(found_position == ELEMENT_NOT_FOUND || positionComesFirst(queue, position, found_position)) {
+                found_position = position;
+            }
+        }
+        return found_position;
+    }
+
+    for(int position = 0; position < queue->size; position++) {
+        if(queue->compare_elements(elementAtPosition(queue, position)->element, element)) {
+            if(found_position == ELEMENT_NOT_FOUND || positionComesFirst(queue, position, found_position)) {
+                found_position = position;
+            }
+        }
+    }
+    return found_position;
+}
+
+
+/**
+ * @brief replaces the storage of queue (list_of_elements, heap, element_index, the storage of an inline queue
+ *        and the elements and priorities) with private copies of it, in a single pass.
+ *        the Elements keep their indices and positions, so the index and the free list are copied as they are.
+ *        the original storage is left untouched
+ *
+ * @return PriorityQueueResult :
+ *         PQ_SUCCESS if the storage was copied
+ *         PQ_OUT_OF_MEMORY if there was not enough memory (or a copy func failed). queue is unchanged in that case
+ */
+static PriorityQueueResult cloneStorage(PriorityQueue queue) {
+    Element* new_list_of_elements = queueMalloc(queue, queue->max_size * sizeof(Element));
+    int* new_heap = queueMalloc(queue, queue->max_size * sizeof(int));
+    HeapKey* new_heap_keys = queueMalloc(queue, queue->max_size * sizeof(HeapKey));
+    char* new_heap_values = NULL;
+    ElementBucket* new_element_index = NULL;
+    char* new_element_storage = NULL;
+    char* new_priority_storage = NULL;
+    if(queue->heap_values != NULL) {
+        new_heap_values = queueMalloc(queue, (size_t)queue->max_size * queue->value_size);
+    }
+    if(isHashed(queue)) {
+        new_element_index = queueMalloc(queue, queue->index_size * sizeof(ElementBucket));
+    }
+    if(isInline(queue)) {
+        new_element_storage = queueMalloc(queue, (size_t)queue->max_size * queue->element_size);
+        new_priority_storage = queueMalloc(queue, (size_t)queue->max_size * queue->priority_size);
+    }
+    if(new_list_of_elements == NULL || new_heap == NULL || new_heap_keys == NULL ||
+       (queue->heap_values != NULL && new_heap_values == NULL) || (isHashed(queue) && new_element_index == NULL) ||
+       (isInline(queue) && (new_element_storage == NULL || new_priority_storage == NULL))) {
+        queueFree(queue, new_list_of_elements);
+        queueFree(queue, new_heap);
+        queueFree(queue, new_heap_keys);
+        queueFree(queue, new_heap_values);
+        queueFree(queue, new_element_index);
+        queueFree(queue, new_element_storage);
+        queueFree(queue, new_priority_storage);
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    memcpy(new_list_of_elements, queue->list_of_elements, queue->max_size * sizeof(Element));
+    memcpy(new_heap, queue->heap, queue->size * sizeof(int));
+    if(isHashed(queue)) {
+        memcpy(new_element_index, queue->element_index, queue->index_size * sizeof(ElementBucket));
+    }
+    if(isInline(queue)) {
+        memcpy(new_element_storage, queue->element_storage, (size_t)queue->max_size * queue->element_size);
+        memcpy(new_priority_storage, queue->priority_storage, (size_t)queue->max_size * queue->priority_size);
+    }
+
+    // copies the element and priority of every Element in the queue
+    for(int position = 0; !isInline(queue) && position < queue->size; position++) {
+        Element* new_element = &new_list_of_elements[new_heap[position]];
+        PQElement element_copy = queue->copy_element(new_element->element);
+        PQElementPriority priority_copy = element_copy == NULL ? NULL : queue->copy_priority(new_element->priority);
+        if(priority_copy == NULL) {
+            if(element_copy != NULL) {
+                queue->free_element(element_copy);
+            }
+            // frees the copies that were already made
+            for(int copied = 0; copied < position; copied++) {
+                queue->free_element(new_list_of_elements[new_heap[copied]].element);
+                queue->free_priority(new_list_of_elements[new_heap[copied]].priority);
+            }
+            queueFree(queue, new_list_of_elements);
+            queueFree(queue, new_heap);
+            queueFree(queue, new_heap_keys);
+            queueFree(queue, new_heap_values);
+            queueFree(queue, new_element_index);
+            return PQ_OUT_OF_MEMORY;
+        }
+        new_element->element = element_copy;
+        new_element->priority = priority_copy;
+    }
+
+    queue->list_of_elements = new_list_of_elements;
+    queue->heap = new_heap;
+    queue->heap_keys = new_heap_keys;
+    queue->heap_values = new_heap_values;
+    queue->element_index = new_element_index;
+    queue->element_storage = new_element_storage;
+    queue->priority_storage = new_priority_storage;
+
+    // the keys point at the new copies of the priorities (the Elements of an inline queue are pointed
+    // at them first)
+    if(isInline(queue)) {
+        rebaseInlineStorage(queue);
+    }
+    for(int position = 0; position < queue->size; position++) {
+        refreshHeapKey(queue, position);
+    }
+
+    return PQ_SUCCESS;
+}
+
+// gives queue its own copy of the storage it shares with snapshots (see pqSnapshot)
+// helper func called by every operation that changes the queue, before changing it
+static PriorityQueueResult detachQueue(PriorityQueue queue) {
+    if(queue->shared_references == NULL) {
+        return PQ_SUCCESS;
+    }
+
+    if(*queue->shared_references > 1) {
+        // the other queues keep the shared storage
+        if(cloneStorage(queue) == PQ_OUT_OF_MEMORY) {
+            return PQ_OUT_OF_MEMORY;
+        }
+        (*queue->shared_references)--;
+    } else {
+        // all the other queues were already detached or destroyed, so the storage is only queue's
+        queueFree(queue, queue->shared_references);
+    }
+    queue->shared_references = NULL;
+
+    return PQ_SUCCESS;
+}
+
+/**
+ * @brief gives queue new empty storage (with its initial capacity) in place of the storage it shares
+ *        with snapshots (see pqSnapshot), leaving the shared storage and its elements to the other queues.
+ *        unlike detachQueue, nothing in the shared storage is copied
+ *
+ * @return PriorityQueueResult :
+ *         PQ_SUCCESS if the queue got its new storage, and is now empty
+ *         PQ_OUT_OF_MEMORY if there was not enough memory. queue is unchanged in that case
+ */
+static PriorityQueueResult leaveSharedStorage(PriorityQueue queue) {
+    assert(queue->shared_references != NULL && *queue->shared_references > 1);
+    int capacity = queue->min_capacity;
+    Element* new_list_of_elements = queueMalloc(queue, capacity * sizeof(Element));
+    int* new_heap = queueMalloc(queue, capacity * sizeof(int));
+    HeapKey* new_heap_keys = queueMalloc(queue, capacity * sizeof(HeapKey));
+    char* new_heap_values = NULL;
+    ElementBucket* new_element_index = NULL;
+    char* new_element_storage = NULL;
+    char* new_priority_storage = NULL;
+    if(queue->heap_values != NULL) {
+        new_heap_values = queueMalloc(queue, (size_t)capacity * queue->value_size);
+    }
+    if(isHashed(queue)) {
+        new_element_index = queueMalloc(queue, INITIAL_INDEX_SIZE * sizeof(ElementBucket));
+    }
+    if(isInline(queue)) {
+        new_element_storage = queueMalloc(queue, (size_t)capacity * queue->element_size);
+        new_priority_storage = queueMalloc(queue, (size_t)capacity * queue->priority_size);
+    }
+    if(new_list_of_elements == NULL || new_heap == NULL || new_heap_keys == NULL ||
+       (queue->heap_values != NULL && new_heap_values == NULL) || (isHashed(queue) && new_element_index == NULL) ||
+       (isInline(queue) && (new_element_storage == NULL || new_priority_storage == NULL))) {
+        queueFree(queue, new_list_of_elements);
+        queueFree(queue, new_heap);
+        queueFree(queue, new_heap_keys);
+        queueFree(queue, new_heap_values);
+        queueFree(queue, new_element_index);
+        queueFree(queue, new_element_storage);
+        queueFree(queue, new_priority_storage);
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the other queues keep the shared storage
+    (*queue->shared_references)--;
+    queue->shared_references = NULL;
+
+    queue->list_of_elements = new_list_of_elements;
+    queue->heap = new_heap;
+    queue->heap_keys = new_heap_keys;
+    queue->heap_values = new_heap_values;
+    queue->element_index = new_element_index;
+    queue->index_size = isHashed(queue) ? INITIAL_INDEX_SIZE : 0;
+    queue->element_storage = new_element_storage;
+    queue->priority_storage = new_priority_storage;
+    queue->max_size = capacity;
+    forgetAllElements(queue);
+
+    return PQ_SUCCESS;
+}
+
+// makes sure that count more elements can be added to the queue, expanding it (once) if needed
+// helper func used before insertions, so that adding the elements themselves can't fail.
+// returns PQ_QUEUE_FULL if a bounded queue doesn't have room for them
+static PriorityQueueResult makeRoomForElements(PriorityQueue queue, int count) {
+    if(queue->bound > 0 && queue->size + count > queue->bound) {
+        return PQ_QUEUE_FULL;
+    }
+
+    // the storage the elements are added to must not be shared
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the queue doesn't have room for count more elements, therefore we need to expand its size
+    if(queue->size + count > queue->max_size) {
+        if(expand(queue, queue->size + count) == PQ_OUT_OF_MEMORY) {
+            return PQ_OUT_OF_MEMORY;
+        }
+    }
+    if(isHashed(queue) && ensureIndexRoom(queue, count) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    return PQ_SUCCESS;
+}
+
+// makes sure that one more element can be added to the queue, expanding it if needed
+static PriorityQueueResult makeRoomForElement(PriorityQueue queue) {
+    return makeRoomForElements(queue, 1);
+}
+
+// copies element and priority into new copies owned by the queue, which are stored in the Element with the given
+// index (an inline queue copies the values into the storage of that Element).
+// on failure nothing is left allocated
+static PriorityQueueResult copyIntoElement(PriorityQueue queue, int element_index,
+                                           PQElement element, PQElementPriority priority) {
+    Element* target = &queue->list_of_elements[element_index];
+    if(isInline(queue)) {
+        target->element = queue->element_storage + (size_t)element_index * queue->element_size;
+        target->priority = queue->priority_storage + (size_t)element_index * queue->priority_size;
+        memcpy(target->element, element, queue->element_size);
+        memcpy(target->priority, priority, queue->priority_size);
+        return PQ_SUCCESS;
+    }
+
+    PQElement new_element = queue->copy_element(element);
+    if(new_element == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    PQElementPriority new_priority = queue->copy_priority(priority);
+    if(new_priority == NULL) {
+        queue->free_element(new_element);
+        return PQ_OUT_OF_MEMORY;
+    }
+    target->element = new_element;
+    target->priority = new_priority;
+    return PQ_SUCCESS;
+}
+
+// puts the Element with the given index in list_of_elements (taken with takeFreeElement, and holding its
+// element and priority) at the end of the heap with the given sequence, without restoring the heap order
+// NOTE: makeRoomForElement must have been called before
+static void appendElementWithSequence(PriorityQueue queue, int element_index, unsigned long sequence) {
+    queue->list_of_elements[element_index].sequence = sequence;
+    if(isHashed(queue)) {
+        indexAddElement(queue, element_index);
+    }
+
+    // queue's size increased by 1
+    placeElement(queue, element_index, queue->size);
+    queue->size++;
+}
+
+// same as appendElementWithSequence, with the next sequence of the queue (the element is the last inserted)
+static void appendElement(PriorityQueue queue, int element_index) {
+    appendElementWithSequence(queue, element_index, queue->next_sequence++);
+}
+
+// adds element with priority to the queue, in the Element with the given index in list_of_elements
+// (taken with takeFreeElement). the queue owns both of them from now on.
+// NOTE: makeRoomForElement must have been called before
+static void addElement(PriorityQueue queue, int element_index, PQElement element, PQElementPriority priority) {
+    queue->list_of_elements[element_index].element = element;
+    queue->list_of_elements[element_index].priority = priority;
+    appendElement(queue, element_index);
+
+    // the new element is moved up to its place in the heap
+    siftUp(queue, queue->size - 1);
+}
+
+// restores the heap order of the whole heap in O(size), by moving every parent down to its place,
+// from the last parent up to the root (Floyd's algorithm)
+static void heapify(PriorityQueue queue) {
+    for(int position = (queue->size - 2) / queue->arity; position >= 0; position--) {
+        siftDown(queue, position);
+    }
+}
+
+// restores the heap order after elements were appended from old_size on, either by moving each of them up
+// or by a single heapify, whichever costs fewer comparisons: moving n elements up costs up to n * height,
+// and a heapify about 2 * size
+static void restoreAppendedElements(PriorityQueue queue, int old_size) {
+    int height = 0;
+    for(int size = queue->size; size > 1; size /= queue->arity) {
+        height++;
+    }
+    if((long)(queue->size - old_size) * height > 2L * queue->size) {
+        heapify(queue);
+        return;
+    }
+    for(int position = old_size; position < queue->size; position++) {
+        siftUp(queue, position);
+    }
+}
+
+// takes the Element at position out of the queue, and hands its element and priority to the caller
+// (who is responsible for freeing them).
+// NOTE: in an inline queue, the values stay in the storage only until the next insertion
+static void takeElementAtPosition(PriorityQueue queue, int position,
+                                  PQElement* element, PQElementPriority* priority) {
+    *element = elementAtPosition(queue, position)->element;
+    *priority = elementAtPosition(queue, position)->priority;
+    removeElementAtPosition(queue, position);
+}
+
+
+/*----------------------------------------------------------------------
+                             Creation functions
+ ----------------------------------------------------------------------*/
+
+// Allocates a new empty priority queue, with an element index if hash_element isn't NULL
+// helper func used in pqCreate and pqCreateHashed (the parameters are already checked)
+static PriorityQueue createQueue(CopyPQElement copy_element,
+                                 FreePQElement free_element,
+                                 EqualPQElements equal_elements,
+                                 HashPQElement hash_element,
+                                 CopyPQElementPriority copy_priority,
+                                 FreePQElementPriority free_priority,
+                                 ComparePQElementPriorities compare_priorities,
+                                 const PQOptions* options) {
+    // the options that weren't given (or are 0) take the default values
+    int initial_capacity = INITIAL_SIZE;
+    double growth_factor = EXPAND_RATE;
+    double shrink_threshold = 0;
+    bool double_ended = false;
+    int arity = DEFAULT_ARITY;
+    PQPriorityType priority_type = PQ_PRIORITY_CUSTOM;
+    PQAllocator allocator = default_allocator;
+    if(options != NULL) {
+        initial_capacity = options->initial_capacity > 0 ? options->initial_capacity : INITIAL_SIZE;
+        growth_factor = options->growth_factor > 0 ? options->growth_factor : EXPAND_RATE;
+        shrink_threshold = options->shrink_threshold;
+        double_ended = options->double_ended;
+        arity = options->arity > 0 ? options->arity : DEFAULT_ARITY;
+        priority_type = options->priority_type;
+        if(options->allocator != NULL) {
+            allocator = *options->allocator;
+        }
+    }
+
+    // allocate space for the queue, with the allocator all its other allocations will use
+    PriorityQueue queue = allocator.alloc(allocator.context, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->allocator = allocator;
+    queue->internal_iterator.allocator = allocator;
+
+    // allocate space for the list_of_elements and the heap, using the initial capacity
+    queue->list_of_elements = queueMalloc(queue, initial_capacity * sizeof(Element));
+    queue->heap = queueMalloc(queue, initial_capacity * sizeof(int));
+    queue->heap_keys = queueMalloc(queue, initial_capacity * sizeof(HeapKey));
+    queue->priority_type = priority_type;
+    queue->value_size = priorityTypeSize(priority_type);
+    queue->heap_values = NULL;
+    queue->kernels = NULL;
+    if(queue->value_size > 0) {
+        queue->heap_values = queueMalloc(queue, (size_t)initial_capacity * queue->value_size);
+        queue->kernels = pqSimdKernels(priority_type, pqSimdBestLevel());
+    }
+    queue->internal_iterator.frontier = queueMalloc(queue, initial_capacity * sizeof(int));
+    queue->element_index = NULL;
+    queue->index_size = 0;
+    queue->index_used = 0;
+    queue->element_size = 0;
+    queue->priority_size = 0;
+    queue->element_storage = NULL;
+    queue->priority_storage = NULL;
+    queue->shared_references = NULL;
+    if(hash_element != NULL) {
+        queue->element_index = createElementIndex(queue, INITIAL_INDEX_SIZE);
+        queue->index_size = INITIAL_INDEX_SIZE;
+    }
+    if(queue->list_of_elements == NULL || queue->heap == NULL || queue->heap_keys == NULL ||
+       (queue->value_size > 0 && queue->heap_values == NULL) || queue->internal_iterator.frontier == NULL ||
+       (hash_element != NULL && queue->element_index == NULL)) {
+        queueFree(queue, queue->list_of_elements);
+        queueFree(queue, queue->heap);
+        queueFree(queue, queue->heap_keys);
+        queueFree(queue, queue->heap_values);
+        queueFree(queue, queue->internal_iterator.frontier);
+        queueFree(queue, queue->element_index);
+        allocatorFree(&allocator, queue);
+        return NULL;
+    }
+
+    // the size of the queue when first created is 0
+    queue->size = 0;
+    queue->max_size = initial_capacity;
+    queue->growth_factor = growth_factor;
+    queue->shrink_threshold = shrink_threshold;
+    queue->min_capacity = initial_capacity;
+    queue->double_ended = double_ended;
+    queue->arity = arity;
+    queue->bound = 0;
+    queue->bound_policy = PQ_BOUND_REJECT;
+    queue->next_sequence = 0;
+    queue->first_free_element = ELEMENT_NOT_FOUND;
+    addFreeElements(queue, 0, initial_capacity);
+    queue->version = 0;
+    queue->internal_iterator.queue = queue;
+    clearIterator(queue);
+
+    // use the funcs given by the user
+    queue->copy_element = copy_element;
+    queue->free_element = free_element;
+    queue->compare_elements = equal_elements;
+    queue->hash_element = hash_element;
+    queue->copy_priority = copy_priority;
+    queue->free_priority = free_priority;
+    queue->compare_priorities = compare_priorities;
+    if(priority_type == PQ_PRIORITY_INT32) {
+        queue->compare_priorities = compareInt32Priorities;
+    } else if(priority_type == PQ_PRIORITY_FLOAT) {
+        queue->compare_priorities = compareFloatPriorities;
+    } else if(priority_type == PQ_PRIORITY_DOUBLE) {
+        queue->compare_priorities = compareDoublePriorities;
+    }
+    queue->free_element_batch = NULL;
+    queue->free_priority_batch = NULL;
+
+    return queue;
+}
+
+// Allocates a new empty priority queue
+PriorityQueue pqCreate(CopyPQElement copy_element,
+                       FreePQElement free_element,
+                       EqualPQElements equal_elements,
+                       CopyPQElementPriority copy_priority,
+                       FreePQElementPriority free_priority,
+                       ComparePQElementPriorities compare_priorities) {
+    // check for NULL parameters
+    if(copy_element == NULL || free_element == NULL || equal_elements == NULL ||
+    copy_priority == NULL || free_priority == NULL || compare_priorities == NULL) {
+        return NULL;
+    }
+
+    return createQueue(copy_element, free_element, equal_elements, NULL,
+                       copy_priority, free_priority, compare_priorities, NULL);
+}
+
+// Allocates a new empty priority queue that finds elements through their hashes
+PriorityQueue pqCreateHashed(CopyPQElement copy_element,
+                             FreePQElement free_element,
+                             EqualPQElements equal_elements,
+                             HashPQElement hash_element,
+                             CopyPQElementPriority copy_priority,
+                             FreePQElementPriority free_priority,
+                             ComparePQElementPriorities compare_priorities) {
+    // check for NULL parameters
+    if(copy_element == NULL || free_element == NULL || equal_elements == NULL || hash_element == NULL ||
+    copy_priority == NULL || free_priority == NULL || compare_priorities == NULL) {
+        return NULL;
+    }
+
+    return createQueue(copy_element, free_element, equal_elements, hash_element,
+                       copy_priority, free_priority, compare_priorities, NULL);
+}
+
+// Allocates a new empty priority queue with the given capacity options
+PriorityQueue pqCreateWithOptions(CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  EqualPQElements equal_elements,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities,
+                                  const PQOptions* options) {
+    // check for NULL parameters. primitive priorities are compared by the queue itself
+    if(copy_element == NULL || free_element == NULL || equal_elements == NULL ||
+    copy_priority == NULL || free_priority == NULL || options == NULL ||
+    (compare_priorities == NULL && options->priority_type == PQ_PRIORITY_CUSTOM)) {
+        return NULL;
+    }
+
+    // check for invalid options. a queue that shrinks must keep room to grow after shrinking
+    // (shrink_threshold * growth_factor < 1), or it would shrink and grow back over and over
+    double growth_factor = options->growth_factor > 0 ? options->growth_factor : EXPAND_RATE;
+    if(options->initial_capacity < 0 || growth_factor <= 1 || options->shrink_threshold < 0 ||
+       options->shrink_threshold * growth_factor >= 1) {
+        return NULL;
+    }
+
+    // a min-max heap is always binary
+    if(options->arity < 0 || options->arity > MAX_ARITY || options->arity == 1 ||
+       (options->double_ended && options->arity > DEFAULT_ARITY)) {
+        return NULL;
+    }
+    if(options->priority_type < PQ_PRIORITY_CUSTOM || options->priority_type > PQ_PRIORITY_DOUBLE) {
+        return NULL;
+    }
+    if(options->allocator != NULL && (options->allocator->alloc == NULL || options->allocator->realloc == NULL ||
+       options->allocator->free == NULL)) {
+        return NULL;
+    }
+
+    return createQueue(copy_element, free_element, equal_elements, options->hash_element,
+                       copy_priority, free_priority, compare_priorities, options);
+}
+
+// Allocates a new empty priority queue that allocates its memory with allocator
+PriorityQueue pqCreateWithAllocator(CopyPQElement copy_element,
+                                    FreePQElement free_element,
+                                    EqualPQElements equal_elements,
+                                    CopyPQElementPriority copy_priority,
+                                    FreePQElementPriority free_priority,
+                                    ComparePQElementPriorities compare_priorities,
+                                    const PQAllocator* allocator) {
+    if(allocator == NULL) {
+        return NULL;
+    }
+
+    PQOptions options = {0};
+    options.allocator = allocator;
+    return pqCreateWithOptions(copy_element, free_element, equal_elements,
+                               copy_priority, free_priority, compare_priorities, &options);
+}
+
+// Allocates a new empty priority queue that holds at most capacity elements
+PriorityQueue pqCreateBounded(int capacity,
+                              PQBoundPolicy policy,
+                              CopyPQElement copy_element,
+                              FreePQElement free_element,
+                              EqualPQElements equal_elements,
+                              CopyPQElementPriority copy_priority,
+                              FreePQElementPriority free_priority,
+                              ComparePQElementPriorities compare_priorities) {
+    if(capacity <= 0 || (policy != PQ_BOUND_REJECT && policy != PQ_BOUND_EVICT_MIN)) {
+        return NULL;
+    }
+
+    // all of the capacity is allocated up front, and the lowest priority element is kept at hand for evictions
+    PQOptions options = {0};
+    options.initial_capacity = capacity;
+    options.double_ended = true;
+    PriorityQueue queue = pqCreateWithOptions(copy_element, free_element, equal_elements,
+                                              copy_priority, free_priority, compare_priorities, &options);
+    if(queue == NULL) {
+        return NULL;
+    }
+    queue->bound = capacity;
+    queue->bound_policy = policy;
+
+    return queue;
+}
+
+// Allocates a new priority queue holding copies of the given elements and priorities
+PriorityQueue pqCreateFromArray(CopyPQElement copy_element,
+                                FreePQElement free_element,
+                                EqualPQElements equal_elements,
+                                CopyPQElementPriority copy_priority,
+                                FreePQElementPriority free_priority,
+                                ComparePQElementPriorities compare_priorities,
+                                PQElement elements[],
+                                PQElementPriority priorities[],
+                                int n) {
+    PriorityQueue queue = pqCreate(copy_element, free_element, equal_elements,
+                                   copy_priority, free_priority, compare_priorities);
+    if(queue == NULL) {
+        return NULL;
+    }
+
+    if(pqInsertBulk(queue, elements, priorities, n) != PQ_SUCCESS) {
+        pqDestroy(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+// Allocates a new empty priority queue that stores its elements and priorities by value
+PriorityQueue pqCreateInline(int element_size,
+                             int priority_size,
+                             EqualPQElements equal_elements,
+                             ComparePQElementPriorities compare_priorities) {
+    // check for NULL and invalid parameters
+    if(equal_elements == NULL || compare_priorities == NULL || element_size <= 0 || priority_size <= 0) {
+        return NULL;
+    }
+
+    PriorityQueue queue = createQueue(NULL, NULL, equal_elements, NULL, NULL, NULL, compare_priorities, NULL);
+    if(queue == NULL) {
+        return NULL;
+    }
+
+    // allocate the storage for the values, with room for max_size of each
+    queue->element_size = element_size;
+    queue->priority_size = priority_size;
+    queue->element_storage = queueMalloc(queue, (size_t)queue->max_size * element_size);
+    queue->priority_storage = queueMalloc(queue, (size_t)queue->max_size * priority_size);
+    if(queue->element_storage == NULL || queue->priority_storage == NULL) {
+        pqDestroy(queue);
+        return NULL;
+    }
+
+    return queue;
+}
+
+// Deallocates an existing priority queue. Clears all elements by using the free functions
+void pqDestroy (PriorityQueue queue) {
+    if(queue == NULL) {
+        return;
+    }
+
+    // clears the iterator
+    clearIterator(queue);
+
+    // a queue that shares its storage with other queues leaves it to them
+    PQAllocator allocator = queue->allocator;
+    if(queue->shared_references != NULL && *queue->shared_references > 1) {
+        (*queue->shared_references)--;
+        queueFree(queue, queue->internal_iterator.frontier);
+        allocatorFree(&allocator, queue);
+        return;
+    }
+    queueFree(queue, queue->shared_references);
+    queue->shared_references = NULL;
+
+    // first free the elements inside of the "list_of_elements", in a single sweep
+    removeAllElements(queue);
+
+    // first frees the list of elements, heap, iterator and element index arrays, and then the queue itself
+    queueFree(queue, queue->list_of_elements);
+    queueFree(queue, queue->heap);
+    queueFree(queue, queue->heap_keys);
+    queueFree(queue, queue->heap_values);
+    queueFree(queue, queue->internal_iterator.frontier);
+    queueFree(queue, queue->element_index);
+    queueFree(queue, queue->element_storage);
+    queueFree(queue, queue->priority_storage);
+    allocatorFree(&allocator, queue);
+
+    // set queue to NULL so that user knows queue is now deallocated and not for use
+    queue = NULL;
+}
+
+// Creates a copy of target priority queue.
+// Iterator values for both priority queues are undefined after this operation.
+PriorityQueue pqCopy(PriorityQueue queue) {
+    if(queue == NULL) {
+        return NULL;
+    }
+
+    // the new queue starts as queue (same funcs, sizes and sequence numbers) with its own iterator.
+    // its storage is then cloned in one pass, which keeps every element at the same position it has in queue
+    PriorityQueue new_queue = queueMalloc(queue, sizeof(*new_queue));
+    if(new_queue == NULL) {
+        return NULL;
+    }
+    *new_queue = *queue;
+    new_queue->shared_references = NULL;
+    new_queue->version = 0;
+    new_queue->internal_iterator.queue = new_queue;
+    new_queue->internal_iterator.frontier = queueMalloc(queue, queue->max_size * sizeof(int));
+    if(new_queue->internal_iterator.frontier == NULL || cloneStorage(new_queue) == PQ_OUT_OF_MEMORY) {
+        queueFree(queue, new_queue->internal_iterator.frontier);
+        queueFree(queue, new_queue);
+        return NULL;
+    }
+
+    // set both the queue's and new_queue's iterators to be undefined
+    clearIterator(queue);
+    clearIterator(new_queue);
+
+    return new_queue;
+}
+
+
+
+/*----------------------------------------------------------------------
+                              Queue operations
+ ----------------------------------------------------------------------*/
+
+// Makes sure the queue can hold capacity elements without expanding
+PriorityQueueResult pqReserve(PriorityQueue queue, int capacity) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(capacity < 0) {
+        return PQ_ERROR;
+    }
+    if(queue->bound > 0 && capacity > queue->bound) {
+        capacity = queue->bound;
+    }
+    if(capacity <= queue->size) {
+        return PQ_SUCCESS;
+    }
+
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(capacity > queue->max_size && resizeQueue(queue, capacity) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    if(isHashed(queue) && ensureIndexRoom(queue, capacity - queue->size) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the elements don't move, but the iterators are undefined after this operation
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// Shrinks the capacity of the queue to its size
+PriorityQueueResult pqShrinkToFit(PriorityQueue queue) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    int new_size = queue->size > 0 ? queue->size : 1;
+    if(new_size < queue->max_size) {
+        if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+            return PQ_OUT_OF_MEMORY;
+        }
+        resizeQueue(queue, new_size);
+        markQueueChanged(queue);
+    }
+
+    return PQ_SUCCESS;
+}
+
+// Returns the number of elements the queue can hold without expanding
+int pqGetCapacity(PriorityQueue queue) {
+    if(queue == NULL) {
+        return -1;
+    }
+    return queue->max_size;
+}
+
+// Sets functions that free arrays of elements and priorities, used by pqClear and pqDestroy
+PriorityQueueResult pqSetFreeBatch(PriorityQueue queue, FreePQElementBatch free_element_batch,
+                                   FreePQElementPriorityBatch free_priority_batch) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(isInline(queue)) {
+        return PQ_ERROR;
+    }
+    queue->free_element_batch = free_element_batch;
+    queue->free_priority_batch = free_priority_batch;
+    return PQ_SUCCESS;
+}
+
+// Creates a copy of the priority queue that shares its storage with queue until one of them is changed
+PriorityQueue pqSnapshot(PriorityQueue queue) {
+    if(queue == NULL) {
+        return NULL;
+    }
+
+    PriorityQueue snapshot = queueMalloc(queue, sizeof(*snapshot));
+    int* frontier = queueMalloc(queue, queue->max_size * sizeof(int));
+    if(queue->shared_references == NULL && snapshot != NULL && frontier != NULL) {
+        queue->shared_references = queueMalloc(queue, sizeof(int));
+        if(queue->shared_references != NULL) {
+            *queue->shared_references = 1;
+        }
+    }
+    if(snapshot == NULL || frontier == NULL || queue->shared_references == NULL) {
+        queueFree(queue, snapshot);
+        queueFree(queue, frontier);
+        return NULL;
+    }
+
+    // the snapshot is queue itself (including the pointers to its storage), with its own iterator
+    (*queue->shared_references)++;
+    *snapshot = *queue;
+    snapshot->version = 0;
+    snapshot->internal_iterator.queue = snapshot;
+    snapshot->internal_iterator.frontier = frontier;
+
+    // set both the queue's and snapshot's iterators to be undefined
+    clearIterator(queue);
+    clearIterator(snapshot);
+
+    return snapshot;
+}
+
+// Returns the number of elements in a priority queue
+int pqGetSize(PriorityQueue queue) {
+    if(queue == NULL) {
+        return -1;
+    }
+    return queue->size;
+}
+
+// Checks if an element exists in the priority queue. The element will be
+// considered in the priority queue if one of the elements in the priority queue it determined equal
+// using the comparison function used to initialize the priority queue.
+bool pqContains(PriorityQueue queue, PQElement element) {
+    if(queue == NULL || element == NULL) {
+        return NULL;
+    }
+
+    // a hashed queue finds the element's bucket directly
+    if(isHashed(queue)) {
+        return firstEqualElement(queue, element) != ELEMENT_NOT_FOUND;
+    }
+
+    // goes through the heap to check for a matching element
+    for(int position = 0; position < queue->size; position++) {
+        if(queue->compare_elements(elementAtPosition(queue, position)->element, element)) {
+            return true; //matching element found
+        }
+    }
+
+    return false; //element was not found
+}
+
+// Add a specified element with a specific priority.
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPriority priority) {
+    if(queue == NULL || element == NULL || priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // a full bounded queue rejects the element or evicts its lowest priority element, by its policy
+    if(queue->bound > 0 && queue->size == queue->bound) {
+        return pqInsertEvict(queue, element, priority, NULL, NULL);
+    }
+
+    PriorityQueueResult result = makeRoomForElement(queue);
+    if(result != PQ_SUCCESS) {
+        return result;
+    }
+
+    // copies the inputted element and priority, before adding them to the queue
+    int element_index = takeFreeElement(queue);
+    if(copyIntoElement(queue, element_index, element, priority) == PQ_OUT_OF_MEMORY) {
+        releaseElement(queue, element_index);
+        return PQ_OUT_OF_MEMORY;
+    }
+    appendElement(queue, element_index);
+    siftUp(queue, queue->size - 1);
+
+    // queue's iterators are undefined after insert
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// Adds an element to a bounded queue, evicting its lowest priority element if it is full (by its policy)
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqInsertEvict(PriorityQueue queue, PQElement element, PQElementPriority priority,
+                                  PQElement* evicted_element, PQElementPriority* evicted_priority) {
+    if(queue == NULL || element == NULL || priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // the values of an inline queue can't be handed out
+    if(isInline(queue) && (evicted_element != NULL || evicted_priority != NULL)) {
+        return PQ_ERROR;
+    }
+    if(evicted_element != NULL) {
+        *evicted_element = NULL;
+    }
+    if(evicted_priority != NULL) {
+        *evicted_priority = NULL;
+    }
+    if(queue->bound == 0 || queue->size < queue->bound) {
+        return pqInsert(queue, element, priority);
+    }
+
+    // a full REJECT queue takes nothing
+    if(queue->bound_policy == PQ_BOUND_REJECT) {
+        return PQ_QUEUE_FULL;
+    }
+
+    // the new element is rejected if it would be the lowest priority element itself
+    // (an equal priority would be removed after the current lowest one, as it was inserted later)
+    int last_position = lastPosition(queue);
+    if(queue->compare_priorities(priority, elementAtPosition(queue, last_position)->priority) <= 0) {
+        return PQ_QUEUE_FULL;
+    }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the copies are made before evicting, so the queue is left as it was if they fail
+    // (an inline queue copies the values into the evicted element's storage, which can't fail)
+    PQElement new_element = NULL;
+    PQElementPriority new_priority = NULL;
+    if(!isInline(queue)) {
+        new_element = queue->copy_element(element);
+        if(new_element == NULL) {
+            return PQ_OUT_OF_MEMORY;
+        }
+        new_priority = queue->copy_priority(priority);
+        if(new_priority == NULL) {
+            queue->free_element(new_element);
+            return PQ_OUT_OF_MEMORY;
+        }
+    }
+
+    // the caller gets the evicted element if it asked for it, otherwise it is freed
+    PQElement removed_element;
+    PQElementPriority removed_priority;
+    takeElementAtPosition(queue, last_position, &removed_element, &removed_priority);
+    if(evicted_element != NULL) {
+        *evicted_element = removed_element;
+    } else {
+        freeQueueElement(queue, removed_element);
+    }
+    if(evicted_priority != NULL) {
+        *evicted_priority = removed_priority;
+    } else {
+        freeQueuePriority(queue, removed_priority);
+    }
+
+    int element_index = takeFreeElement(queue);
+    if(isInline(queue)) {
+        copyIntoElement(queue, element_index, element, priority);
+        appendElement(queue, element_index);
+        siftUp(queue, queue->size - 1);
+    } else {
+        addElement(queue, element_index, new_element, new_priority);
+    }
+
+    // queue's iterators are undefined after insert
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// Adds n elements with their priorities, reserving room for all of them once and restoring the heap once.
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqInsertBatch(PriorityQueue queue, PQElement elements[], PQElementPriority priorities[], int n) {
+    if(queue == NULL || (n > 0 && (elements == NULL || priorities == NULL))) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(n < 0) {
+        return PQ_ERROR;
+    }
+    for(int i = 0; i < n; i++) {
+        if(elements[i] == NULL || priorities[i] == NULL) {
+            return PQ_NULL_ARGUMENT;
+        }
+    }
+
+    PriorityQueueResult result = makeRoomForElements(queue, n);
+    if(result != PQ_SUCCESS) {
+        return result;
+    }
+
+    // the copies are appended to the end of the heap, in the order of the arrays (which is
+    // also the insertion order for equal priorities)
+    int old_size = queue->size;
+    for(int i = 0; i < n; i++) {
+        int element_index = takeFreeElement(queue);
+        if(copyIntoElement(queue, element_index, elements[i], priorities[i]) == PQ_OUT_OF_MEMORY) {
+            releaseElement(queue, element_index);
+
+            // takes the copies that were already appended back out, so the queue is left as it was
+            while(queue->size > old_size) {
+                PQElement removed_element;
+                PQElementPriority removed_priority;
+                takeElementAtPosition(queue, queue->size - 1, &removed_element, &removed_priority);
+                freeQueueElement(queue, removed_element);
+                freeQueuePriority(queue, removed_priority);
+            }
+            queue->next_sequence -= i;
+            return PQ_OUT_OF_MEMORY;
+        }
+        appendElement(queue, element_index);
+    }
+
+    // the heap is restored once for the whole batch
+    restoreAppendedElements(queue, old_size);
+
+    // queue's iterators are undefined after insert
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// Same as pqInsertBatch.
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqInsertBulk(PriorityQueue queue, PQElement elements[], PQElementPriority priorities[], int n) {
+    return pqInsertBatch(queue, elements, priorities, n);
+}
+
+// Add a specified element with a specific priority, without copying them.
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqInsertOwned(PriorityQueue queue, PQElement element, PQElementPriority priority) {
+    if(queue == NULL || element == NULL || priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // an inline queue has no free funcs to free the adopted pointers with
+    if(isInline(queue)) {
+        return PQ_ERROR;
+    }
+
+    // on failure the caller still owns element and priority
+    PriorityQueueResult result = makeRoomForElement(queue);
+    if(result != PQ_SUCCESS) {
+        return result;
+    }
+    addElement(queue, takeFreeElement(queue), element, priority);
+
+    // queue's iterators are undefined after insert
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// returns true if the elements and priorities of source can be moved into destination (see pqMeld):
+// destination frees, compares and stores them the same way source does
+static bool queuesCanMeld(const PriorityQueue destination, const PriorityQueue source) {
+    if(isInline(destination) != isInline(source) || destination->priority_type != source->priority_type ||
+       destination->compare_elements != source->compare_elements ||
+       destination->compare_priorities != source->compare_priorities) {
+        return false;
+    }
+    if(isInline(destination)) {
+        return destination->element_size == source->element_size &&
+               destination->priority_size == source->priority_size;
+    }
+    return destination->free_element == source->free_element && destination->free_priority == source->free_priority;
+}
+
+// Moves all the elements of source into destination, without copying them.
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqMeld(PriorityQueue destination, PriorityQueue source) {
+    if(destination == NULL || source == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(destination == source || !queuesCanMeld(destination, source)) {
+        return PQ_ERROR;
+    }
+
+    // the elements of source are taken out of its storage, which must not be shared with a snapshot
+    if(detachQueue(source) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    PriorityQueueResult result = makeRoomForElements(destination, source->size);
+    if(result != PQ_SUCCESS) {
+        return result;
+    }
+
+    // the Elements of source are appended to the end of the heap. their sequences are moved past those of
+    // destination, which keeps their own order (an inline queue copies the values, which can't fail)
+    unsigned long first_sequence = destination->next_sequence;
+    int old_size = destination->size;
+    for(int position = 0; position < source->size; position++) {
+        const Element* moved = elementAtPosition(source, position);
+        int element_index = takeFreeElement(destination);
+        if(isInline(destination)) {
+            copyIntoElement(destination, element_index, moved->element, moved->priority);
+        } else {
+            destination->list_of_elements[element_index].element = moved->element;
+            destination->list_of_elements[element_index].priority = moved->priority;
+        }
+        appendElementWithSequence(destination, element_index, first_sequence + moved->sequence);
+    }
+    destination->next_sequence = first_sequence + source->next_sequence;
+
+    // the heap is restored once for all of them, and source no longer owns them
+    restoreAppendedElements(destination, old_size);
+    forgetAllElements(source);
+    shrinkIfSparse(source);
+
+    // the iterators of both queues are undefined after meld
+    markQueueChanged(destination);
+    markQueueChanged(source);
+
+    return PQ_SUCCESS;
+}
+
+// Changes the priority of specific element with a specific priority in the priority queue.
+// See header file for important note.
+PriorityQueueResult pqChangePriority(PriorityQueue queue, PQElement element,
+                                        PQElementPriority old_priority, PQElementPriority new_priority) {
+    if(queue == NULL || element == NULL || old_priority == NULL || new_priority == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // first looks for the element in the heap
+    int found_position = findElementWithPriority(queue, element, old_priority);
+    if(found_position == ELEMENT_NOT_FOUND) {
+        return PQ_ELEMENT_DOES_NOT_EXISTS;
+    }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the element keeps its Element (and its copy of element), only the priority is replaced.
+    // it is considered as reinserted, so it gets a new sequence number
+    Element* found = elementAtPosition(queue, found_position);
+    if(isInline(queue)) {
+        // an inline queue overwrites the priority in place
+        memcpy(found->priority, new_priority, queue->priority_size);
+    } else {
+        // copies the new priority before touching the found Element, so a failed copy changes nothing
+        PQElementPriority new_priority_copy = queue->copy_priority(new_priority);
+        if(new_priority_copy == NULL) {
+            return PQ_OUT_OF_MEMORY;
+        }
+        queue->free_priority(found->priority);
+        found->priority = new_priority_copy;
+    }
+    found->sequence = queue->next_sequence++;
+    refreshHeapKey(queue, found_position);
+
+    // moves the element up or down the heap to its new place
+    restoreHeapAt(queue, found_position);
+
+    // the iterators are undefined after changing the priority
+    markQueueChanged(queue);
+    return PQ_SUCCESS;
+
+}
+
+// Removes the highest priority element from the priority queue.
+// see header file for important notes.
 PriorityQueueResult pqRemove(PriorityQueue queue) {
     if(queue == NULL) {
         return PQ_NULL_ARGUMENT;
@@ -487,51 +2334,215 @@ PriorityQueueResult pqRemove(PriorityQueue queue) {
         return PQ_SUCCESS;
     }
 
-    // finds the index of the element in queue's list_of_elements that needs to be removed
-    int highest_priority_element_index = findHighestPriorityElementIndex(queue);
+    // pqPop frees both the element and the priority when they aren't asked for
+    return pqPop(queue, NULL, NULL);
+}
+
+// Removes the highest priority element from the priority queue, and hands it to the caller.
+// see header file for important notes.
+PriorityQueueResult pqPop(PriorityQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(pqIsEmpty(queue)) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
 
-    // freeing the memory inside Element (both element and priority)
-    queue->free_element(queue->list_of_elements[highest_priority_element_index].element);
-    queue->free_priority(queue->list_of_elements[highest_priority_element_index].priority);
+    // the values of an inline queue can't be handed out, they are read with pqPopInto instead
+    if(isInline(queue) && (element != NULL || priority != NULL)) {
+        return PQ_ERROR;
+    }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
 
-    // moving over the elements after highest_piority_element_index
-    queue->list_of_elements[highest_priority_element_index] = queue->list_of_elements[queue->size - 1];
-    queue->size--;
+    // the highest priority element is always at the root of the heap.
+    // the last element takes the root's place and is moved down to restore the heap
+    PQElement removed_element;
+    PQElementPriority removed_priority;
+    takeElementAtPosition(queue, 0, &removed_element, &removed_priority);
+
+    // the caller gets what it asked for, and the rest is freed
+    if(element != NULL) {
+        *element = removed_element;
+    } else {
+        freeQueueElement(queue, removed_element);
+    }
+    if(priority != NULL) {
+        *priority = removed_priority;
+    } else {
+        freeQueuePriority(queue, removed_priority);
+    }
 
-    // iterator is undefined after pqRemove
-    clearIterator(queue);
+    // gives back memory the queue no longer needs (if it shrinks)
+    shrinkIfSparse(queue);
+
+    // iterators are undefined after pqPop
+    markQueueChanged(queue);
 
     return PQ_SUCCESS;
 }
 
-// Removes the highest priority element from the priority queue which have its value equal to element.
-PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element) {
-    if(queue == NULL || element == NULL) {
+// Removes the highest priority element from the priority queue, and hands it to the caller without freeing it.
+PriorityQueueResult pqPopOwned(PriorityQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL || element == NULL || priority == NULL) {
         return PQ_NULL_ARGUMENT;
     }
+    return pqPop(queue, element, priority);
+}
 
-    // checks that the element is in the queue
-    bool element_found = false;
-    for(int i = 0; i < queue->size; i++) {
-        if(queue->compare_elements(queue->list_of_elements[i].element, element)) {
-            element_found = true;
+// Removes the k highest priority elements, in order, and hands them to the caller.
+// NOTE: Iterator's value is undefined after this operation.
+int pqPopBatch(PriorityQueue queue, int k, PQElement elements[], PQElementPriority priorities[]) {
+    if(queue == NULL || k < 0) {
+        return -1;
+    }
 
-            // free element and priority in Element
-            queue->free_element(queue->list_of_elements[i].element); //ERRORS HERE
-            queue->free_priority(queue->list_of_elements[i].priority);
-            moveElementsLeft(queue, i);
-                
-            queue->size--;
-            break;
+    // the values of an inline queue can't be handed out, they are read with pqPopInto instead
+    if(isInline(queue) && (elements != NULL || priorities != NULL)) {
+        return -1;
+    }
+    if(k > queue->size) {
+        k = queue->size;
+    }
+    if(k == 0) {
+        return 0;
+    }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return -1;
+    }
+
+    // the root is taken out k times, with the checks, shrinking and iterator invalidation done once
+    for(int i = 0; i < k; i++) {
+        PQElement removed_element;
+        PQElementPriority removed_priority;
+        takeElementAtPosition(queue, 0, &removed_element, &removed_priority);
+        if(elements != NULL) {
+            elements[i] = removed_element;
+        } else {
+            freeQueueElement(queue, removed_element);
+        }
+        if(priorities != NULL) {
+            priorities[i] = removed_priority;
+        } else {
+            freeQueuePriority(queue, removed_priority);
         }
     }
 
-    if(!element_found) {
+    // gives back memory the queue no longer needs (if it shrinks)
+    shrinkIfSparse(queue);
+
+    // iterators are undefined after a pop
+    markQueueChanged(queue);
+
+    return k;
+}
+
+// Removes the lowest priority element from the priority queue, and hands it to the caller.
+// NOTE: Iterator's value is undefined after this operation.
+PriorityQueueResult pqRemoveMin(PriorityQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(pqIsEmpty(queue)) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    // the values of an inline queue can't be handed out
+    if(isInline(queue) && (element != NULL || priority != NULL)) {
+        return PQ_ERROR;
+    }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    PQElement removed_element;
+    PQElementPriority removed_priority;
+    takeElementAtPosition(queue, lastPosition(queue), &removed_element, &removed_priority);
+
+    // the caller gets what it asked for, and the rest is freed
+    if(element != NULL) {
+        *element = removed_element;
+    } else {
+        freeQueueElement(queue, removed_element);
+    }
+    if(priority != NULL) {
+        *priority = removed_priority;
+    } else {
+        freeQueuePriority(queue, removed_priority);
+    }
+
+    // gives back memory the queue no longer needs (if it shrinks)
+    shrinkIfSparse(queue);
+
+    // iterators are undefined after a removal
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// Removes the highest priority element from an inline priority queue, and copies its values out.
+PriorityQueueResult pqPopInto(PriorityQueue queue, void* element_buffer, void* priority_buffer) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(!isInline(queue)) {
+        return PQ_ERROR;
+    }
+    if(pqIsEmpty(queue)) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the values stay in the storage until the next insertion, so they are copied out after the removal
+    PQElement removed_element;
+    PQElementPriority removed_priority;
+    takeElementAtPosition(queue, 0, &removed_element, &removed_priority);
+    if(element_buffer != NULL) {
+        memcpy(element_buffer, removed_element, queue->element_size);
+    }
+    if(priority_buffer != NULL) {
+        memcpy(priority_buffer, removed_priority, queue->priority_size);
+    }
+
+    // gives back memory the queue no longer needs (if it shrinks)
+    shrinkIfSparse(queue);
+
+    // iterators are undefined after pqPopInto
+    markQueueChanged(queue);
+
+    return PQ_SUCCESS;
+}
+
+// Removes the highest priority element from the priority queue which have its value equal to element.
+PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element) {
+    if(queue == NULL || element == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // looks for the matching element that would leave the queue first
+    int found_position = findElementToRemove(queue, element);
+    if(found_position == ELEMENT_NOT_FOUND) {
         return PQ_ELEMENT_DOES_NOT_EXISTS;
     }
+    if(detachQueue(queue) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
 
-    // queue's iterator is undefined after removing an element
-    clearIterator(queue);
+    // take the Element out of the heap, and free element and priority in it
+    PQElement removed_element;
+    PQElementPriority removed_priority;
+    takeElementAtPosition(queue, found_position, &removed_element, &removed_priority);
+    freeQueueElement(queue, removed_element);
+    freeQueuePriority(queue, removed_priority);
+
+    // gives back memory the queue no longer needs (if it shrinks)
+    shrinkIfSparse(queue);
+
+    // queue's iterators are undefined after removing an element
+    markQueueChanged(queue);
 
     return PQ_SUCCESS;
 }
@@ -541,43 +2552,184 @@ PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element) {
 //                                Queue iteration
 //  ----------------------------------------------------------------------*/
 
+// Returns the highest priority element and its priority, without removing it or moving the iterators
+PriorityQueueResult pqPeek(PriorityQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(pqIsEmpty(queue)) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    // the highest priority element is always at the root of the heap
+    Element* first = elementAtPosition(queue, 0);
+    if(element != NULL) {
+        *element = first->element;
+    }
+    if(priority != NULL) {
+        *priority = first->priority;
+    }
+    return PQ_SUCCESS;
+}
+
+// Returns the lowest priority element and its priority, without removing it or moving the iterators
+PriorityQueueResult pqPeekMin(PriorityQueue queue, PQElement* element, PQElementPriority* priority) {
+    if(queue == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(pqIsEmpty(queue)) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    Element* last = elementAtPosition(queue, lastPosition(queue));
+    if(element != NULL) {
+        *element = last->element;
+    }
+    if(priority != NULL) {
+        *priority = last->priority;
+    }
+    return PQ_SUCCESS;
+}
+
+// Returns the k highest priority elements in order, without changing the queue or its iterators
+int pqPeekTopK(PriorityQueue queue, int k, PQElement elements[], PQElementPriority priorities[]) {
+    if(queue == NULL || k < 0 || (k > 0 && elements == NULL)) {
+        return -1;
+    }
+    if(k > queue->size) {
+        k = queue->size;
+    }
+    if(k == 0) {
+        return 0;
+    }
+
+    // walks the heap like an iterator, with a frontier of its own: every step takes one position out of the
+    // frontier and adds its followers, so k * MAX_FOLLOWERS + 1 positions (or size) are enough for k elements
+    int frontier_capacity = queue->size;
+    if((long)k * MAX_FOLLOWERS + 1 < frontier_capacity) {
+        frontier_capacity = k * MAX_FOLLOWERS + 1;
+    }
+    struct PQIterator_t walk;
+    walk.queue = queue;
+    walk.frontier = queueMalloc(queue, frontier_capacity * sizeof(int));
+    if(walk.frontier == NULL) {
+        return -1;
+    }
+    walk.frontier_size = 0;
+    frontierPush(&walk, 0);
+    for(int i = 0; i < k; i++) {
+        int position = frontierPop(&walk);
+        elements[i] = iterateToPosition(&walk, position);
+        if(priorities != NULL) {
+            priorities[i] = elementAtPosition(queue, position)->priority;
+        }
+    }
+    queueFree(queue, walk.frontier);
+
+    return k;
+}
+
+// Returns the number of elements in the queue with a higher priority than priority
+int pqCountHigherPriority(PriorityQueue queue, PQElementPriority priority) {
+    if(queue == NULL || priority == NULL) {
+        return -1;
+    }
+
+    // walks the heap from the root, only past positions with a higher priority
+    // (no follower has a higher priority than the position it follows), so only the counted
+    // elements and their followers are visited
+    int* positions = queueMalloc(queue, (queue->size > 0 ? queue->size : 1) * sizeof(int));
+    if(positions == NULL) {
+        return -1;
+    }
+    int count = 0;
+    int positions_size = 0;
+    if(!pqIsEmpty(queue)) {
+        positions[positions_size++] = 0;
+    }
+    while(positions_size > 0) {
+        int position = positions[--positions_size];
+        if(queue->compare_priorities(elementAtPosition(queue, position)->priority, priority) <= 0) {
+            continue;
+        }
+        count++;
+        positions_size += followersOf(queue, position, positions + positions_size);
+    }
+    queueFree(queue, positions);
+
+    return count;
+}
+
 // Sets the internal iterator (also called current element) to
-// the first element in the priority queue. The internal order derived from the priorities, 
+// the first element in the priority queue. The internal order derived from the priorities,
 // and the tie-breaker between two equal priorities is the insertion order.
 PQElement pqGetFirst(PriorityQueue queue) {
     if(queue == NULL || pqIsEmpty(queue)) {
         return NULL;
     }
 
-    // finds the high priority element in the queue
-    int highest_priority_element_index = findHighestPriorityElementIndex(queue);
-    Element highest_priority_element = queue->list_of_elements[highest_priority_element_index];
-
-    // sets that element's used to be true, meaning that it can't be used again
-    queue->list_of_elements[highest_priority_element_index].used = true;
-
-    return highest_priority_element.element;
+    return iteratorFirst(&queue->internal_iterator);
 }
 
 // Advances the priority queue iterator to the next element and returns it.
 PQElement pqGetNext(PriorityQueue queue) {
-    if(queue == NULL || !iteratorIsDefined(queue)) {
+    if(queue == NULL) {
+        return NULL;
+    }
+    return iteratorNext(&queue->internal_iterator);
+}
+
+// Creates an iterator over queue, that is independent of queue's internal iterator.
+PQIterator pqIterBegin(PriorityQueue queue) {
+    if(queue == NULL) {
+        return NULL;
+    }
+
+    PQIterator iterator = queueMalloc(queue, sizeof(*iterator));
+    if(iterator == NULL) {
         return NULL;
     }
 
-    // looks for the high priority element in the queue that has not been used yet
-    int next_highest_priority_element_index = getNextHighestPriorityElementIndex(queue);
+    // the frontier never holds more positions than there are elements in the queue
+    iterator->allocator = queue->allocator;
+    iterator->frontier = queueMalloc(queue, (queue->size > 0 ? queue->size : 1) * sizeof(int));
+    if(iterator->frontier == NULL) {
+        queueFree(queue, iterator);
+        return NULL;
+    }
+    iterator->queue = queue;
+    iterator->version = queue->version;
+    iterator->defined = false;
+    iterator->frontier_size = 0;
+
+    return iterator;
+}
 
-    //reached the end of the queue
-    if(next_highest_priority_element_index == ELEMENT_NOT_FOUND) {
-        return NULL; 
+// Advances the iterator to the next element and returns it.
+PQElement pqIterNext(PQIterator iterator) {
+    if(iterator == NULL) {
+        return NULL;
     }
 
-    Element next_highest_priority_element = queue->list_of_elements[next_highest_priority_element_index];
+    // the first call returns the first element, unless the queue changed since pqIterBegin
+    if(!iterator->defined) {
+        if(iterator->version != iterator->queue->version) {
+            return NULL;
+        }
+        return iteratorFirst(iterator);
+    }
+    return iteratorNext(iterator);
+}
 
-    queue->list_of_elements[next_highest_priority_element_index].used = true;
-    
-    return next_highest_priority_element.element;
+// Deallocates an iterator.
+void pqIterEnd(PQIterator iterator) {
+    if(iterator == NULL) {
+        return;
+    }
+    // the queue may already be destroyed, so the iterator frees itself with its own copy of the allocator
+    PQAllocator allocator = iterator->allocator;
+    allocatorFree(&allocator, iterator->frontier);
+    allocatorFree(&allocator, iterator);
 }
 
 // Removes all elements and priorities from target priority queue.
@@ -587,13 +2739,24 @@ PriorityQueueResult pqClear(PriorityQueue queue) {
         return PQ_NULL_ARGUMENT;
     }
 
-    // removes the elements from the queue until there are none left
-    while(!pqIsEmpty(queue)) {
-        pqRemove(queue);
+    // a snapshot keeps the shared storage with the elements, so they aren't copied just to be freed
+    if(queue->shared_references != NULL && *queue->shared_references > 1) {
+        if(leaveSharedStorage(queue) == PQ_OUT_OF_MEMORY) {
+            return PQ_OUT_OF_MEMORY;
+        }
+    } else {
+        // the storage is only queue's, so detaching it can't fail
+        detachQueue(queue);
+
+        // frees all the elements in a single sweep
+        removeAllElements(queue);
+
+        // gives back memory the queue no longer needs (if it shrinks)
+        shrinkIfSparse(queue);
     }
 
-    // iterator is undefined after this operation 
-    clearIterator(queue);
+    // iterators are undefined after this operation
+    markQueueChanged(queue);
 
     return PQ_SUCCESS;
 }
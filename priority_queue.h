@@ -2,6 +2,7 @@
 #define PRIORITY_QUEUE_H
 
 #include <stdbool.h>
+#include <stddef.h>
 
 /**
 * Generic Priority Queue Container
@@ -13,20 +14,62 @@
 *
 * The following functions are available:
 *   pqCreate		    - Creates a new empty priority queue
+*   pqCreateHashed	    - Creates a new empty priority queue that finds elements by their hash
+*   pqCreateInline	    - Creates a new empty priority queue that stores fixed-size elements and priorities by value
+*   pqCreateFromArray   - Creates a new priority queue from arrays of elements and priorities in linear time
+*   pqCreateWithOptions - Creates a new empty priority queue with a given capacity and growth policy
+*   pqCreateWithAllocator - Creates a new empty priority queue that allocates its memory with a given allocator
+*   pqDefaultAllocator  - Returns the allocator used when none is given (malloc, realloc and free)
+*   pqCreateBounded	    - Creates a new empty priority queue that holds at most a given number of elements
 *   pqDestroy		    - Deletes an existing priority queue and frees all resources
+*   pqSetFreeBatch	    - Sets functions that free many elements (or priorities) at once, used by pqClear and pqDestroy
 *   pqCopy		        - Copies an existing priority queue
+*   pqSnapshot	        - Copies an existing priority queue lazily, sharing its storage until one of them changes
 *   pqGetSize		    - Returns the size of a given priority queue
+*   pqGetCapacity	    - Returns the number of elements a given priority queue can hold without expanding
+*   pqReserve		    - Makes room for a given number of elements in the priority queue
+*   pqShrinkToFit	    - Shrinks the capacity of the priority queue to its size
 *   pqContains	        - returns whether or not an element exists inside the priority queue.
 *   pqInsert	        - Insert an element with a given priority to the queue.
 *   				        Duplication in the priority queue is allowed.
 *   				        Iterator value is undefined after this operation.
+*   pqInsertEvict	    - Insert an element into a bounded queue, evicting the lowest priority element if it is full.
+*   				        Iterator value is undefined after this operation.
+*   pqInsertBatch	    - Insert n elements with given priorities to the queue, restoring the heap once.
+*   				        Iterator value is undefined after this operation.
+*   pqInsertBulk	    - Same as pqInsertBatch.
+*   				        Iterator value is undefined after this operation.
+*   pqInsertOwned	    - Insert an element with a given priority to the queue without copying them,
+*   				        the queue takes ownership of both.
+*   				        Iterator value is undefined after this operation.
+*   pqMeld		        - Moves all the elements of one queue into another, without copying them.
+*   				        Iterator value is undefined after this operation.
 *   pqChangePriority  	- Changes priority of an element with specific priority
 *					        Iterator value is undefined after this operation.
 *   pqRemove		    - Removes the highest priority element in the queue
 *                           Iterator value is undefined after this operation.
+*   pqPop		        - Removes the highest priority element in the queue and hands it (and its
+*                           priority) to the caller instead of freeing them.
+*                           Iterator value is undefined after this operation.
+*   pqPopOwned	        - Same as pqPop, for both the element and the priority (the counterpart of pqInsertOwned).
+*                           Iterator value is undefined after this operation.
+*   pqRemoveMin	        - Removes the lowest priority element in the queue and hands it to the caller.
+*                           Iterator value is undefined after this operation.
+*   pqPopBatch	        - Removes the k highest priority elements in the queue, in order, and hands them
+*                           to the caller.
+*                           Iterator value is undefined after this operation.
+*   pqPopInto	        - Removes the highest priority element of an inline queue and copies it out.
+*                           Iterator value is undefined after this operation.
+*   pqPeek	            - Returns the highest priority element and its priority without removing it
+*   pqPeekMin	        - Returns the lowest priority element and its priority without removing it
+*   pqPeekTopK	        - Returns the k highest priority elements in order, without removing them
+*   pqCountHigherPriority - Returns the number of elements with a higher priority than a given priority
 *   pqGetFirst	        - Sets the internal iterator to the first element in the priority queue and returns it
 *   pqGetNext		    - Advances the internal iterator to the next key and returns it.
-*	pqClear		        - Clears the contents of the priority queue. Frees all the elements of
+*   pqIterBegin	        - Creates an iterator over the priority queue, independent of the internal iterator
+*   pqIterNext	        - Advances an iterator to the next element and returns it
+*   pqIterEnd	        - Deallocates an iterator
+*	pqClear		        - Clears the contents of the priority queue in linear time. Frees all the elements of
 *	 				        the queue using the free function.
 * 	PQ_FOREACH	        - A macro for iterating over the priority queue's elements.
 */
@@ -34,6 +77,9 @@
 /** Type for defining the priority queue */
 typedef struct PriorityQueue_t *PriorityQueue;
 
+/** Type for iterating over a priority queue without using its internal iterator */
+typedef struct PQIterator_t *PQIterator;
+
 /** Type used for returning error codes from priority queue functions */
 typedef enum PriorityQueueResult_t {
     PQ_SUCCESS,
@@ -41,9 +87,30 @@ typedef enum PriorityQueueResult_t {
     PQ_NULL_ARGUMENT,
     PQ_ELEMENT_DOES_NOT_EXISTS,
     PQ_ITEM_DOES_NOT_EXIST,
-    PQ_ERROR
+    PQ_ERROR,
+    PQ_QUEUE_FULL
 } PriorityQueueResult;
 
+/** What an insertion into a full bounded queue does (see pqCreateBounded) */
+typedef enum PQBoundPolicy_t {
+    /** The new element is rejected */
+    PQ_BOUND_REJECT,
+    /** The lowest priority element is evicted to make room, unless the new element has an even lower priority */
+    PQ_BOUND_EVICT_MIN
+} PQBoundPolicy;
+
+/** The type of the priorities of a queue (see PQOptions) */
+typedef enum PQPriorityType_t {
+    /** Any type, compared with the compare function of the queue */
+    PQ_PRIORITY_CUSTOM,
+    /** Every priority points to an int32_t */
+    PQ_PRIORITY_INT32,
+    /** Every priority points to a float, which is never NaN */
+    PQ_PRIORITY_FLOAT,
+    /** Every priority points to a double, which is never NaN */
+    PQ_PRIORITY_DOUBLE
+} PQPriorityType;
+
 /** Data element data type for priority queue container */
 typedef void *PQElement;
 
@@ -62,6 +129,11 @@ typedef void(*FreePQElement)(PQElement);
 /** Type of function for deallocating a key element of the priority queue */
 typedef void(*FreePQElementPriority)(PQElementPriority);
 
+/** Type of function for deallocating an array of count data elements of the priority queue at once */
+typedef void(*FreePQElementBatch)(PQElement*, int);
+
+/** Type of function for deallocating an array of count key elements of the priority queue at once */
+typedef void(*FreePQElementPriorityBatch)(PQElementPriority*, int);
 
 /**
 * Type of function used by the priority queue to identify equal elements.
@@ -71,6 +143,12 @@ typedef void(*FreePQElementPriority)(PQElementPriority);
 */
 typedef bool(*EqualPQElements)(PQElement, PQElement);
 
+/**
+* Type of function used by a hashed priority queue to hash elements.
+* Elements that are equal (by EqualPQElements) must have the same hash.
+*/
+typedef unsigned long(*HashPQElement)(PQElement);
+
 
 /**
 * Type of function used by the priority queue to compare priorities.
@@ -81,6 +159,61 @@ typedef bool(*EqualPQElements)(PQElement, PQElement);
 */
 typedef int(*ComparePQElementPriorities)(PQElementPriority, PQElementPriority);
 
+/**
+* Allocator used by a priority queue for all of its own memory (see pqCreateWithAllocator).
+* The functions work like malloc, realloc and free, and get context as their first argument.
+* free is never called with NULL. The elements and priorities are still allocated by the copy functions.
+*/
+typedef struct PQAllocator_t {
+    void* (*alloc)(void* context, size_t size);
+    void* (*realloc)(void* context, void* pointer, size_t size);
+    void (*free)(void* context, void* pointer);
+    void* context;
+} PQAllocator;
+
+/**
+* Options for creating a priority queue with pqCreateWithOptions.
+* A field that is 0 (or NULL) takes the default value, so options can be zero-initialized
+* and only the needed fields set.
+*/
+typedef struct PQOptions_t {
+    /** Number of elements the queue can hold before it first expands. Default: 10 */
+    int initial_capacity;
+    /** The capacity is multiplied by growth_factor (greater than 1) every time the queue is full. Default: 2 */
+    double growth_factor;
+    /**
+    * Once less than shrink_threshold of the capacity is used, the queue shrinks its capacity to
+    * size * growth_factor (but never below initial_capacity). Must be less than 1 / growth_factor,
+    * so a shrunk queue doesn't grow back right away. Default: 0, the queue never shrinks by itself.
+    */
+    double shrink_threshold;
+    /** Function for hashing elements, as in pqCreateHashed. Default: NULL, elements aren't indexed */
+    HashPQElement hash_element;
+    /** The allocator of the queue, copied at creation. Default: NULL, malloc, realloc and free are used */
+    const PQAllocator* allocator;
+    /**
+    * If true the queue is double-ended: it keeps a min-max heap, so pqPeekMin and pqRemoveMin take O(1) and
+    * O(log n) time like pqPeek and pqPop (instead of O(n)). Its other operations compare a few more
+    * priorities. Default: false
+    */
+    bool double_ended;
+    /**
+    * The number of children of every node of the heap, 2 to 8. A wider heap is shallower, so popping from a
+    * large queue touches fewer cache lines, at the cost of comparing more children per level. The priorities
+    * of the children are kept next to each other, apart from the elements. A double-ended queue must use 2.
+    * Default: 0, a binary heap (2)
+    */
+    int arity;
+    /**
+    * The type of the priorities. With a primitive type (not PQ_PRIORITY_CUSTOM) the higher value has the
+    * higher priority, and the compare function isn't used (it may be NULL). The queue keeps the values of
+    * the priorities in an array of their own, in heap order, and compares them directly: the children of a
+    * position of a 4-ary or 8-ary heap are searched with SSE4.1 or AVX2 instructions when the CPU has them
+    * (detected at runtime). Default: PQ_PRIORITY_CUSTOM
+    */
+    PQPriorityType priority_type;
+} PQOptions;
+
 
 /**
 * pqCreate: Allocates a new empty priority queue.
@@ -108,6 +241,141 @@ PriorityQueue pqCreate(CopyPQElement copy_element,
                        FreePQElementPriority free_priority,
                        ComparePQElementPriorities compare_priorities);
 
+/**
+* pqCreateHashed: Allocates a new empty priority queue, that also keeps an index of its elements by their hash.
+* pqContains, pqRemoveElement and pqChangePriority find elements through the index
+* instead of going over the whole queue.
+*
+* @param hash_element - Function pointer to be used for hashing elements.
+* 		Equal elements must have equal hashes.
+* The rest of the parameters are the same as in pqCreate.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateHashed(CopyPQElement copy_element,
+                             FreePQElement free_element,
+                             EqualPQElements equal_elements,
+                             HashPQElement hash_element,
+                             CopyPQElementPriority copy_priority,
+                             FreePQElementPriority free_priority,
+                             ComparePQElementPriorities compare_priorities);
+
+/**
+* pqCreateWithOptions: Allocates a new empty priority queue, with the capacity and growth policy in options.
+*
+* @param options - The options of the queue (see PQOptions).
+* The rest of the parameters are the same as in pqCreate, except that compare_priorities may be NULL
+* if the options set a primitive priority type.
+* @return
+* 	NULL - if one of the parameters is NULL, options are invalid, or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateWithOptions(CopyPQElement copy_element,
+                                  FreePQElement free_element,
+                                  EqualPQElements equal_elements,
+                                  CopyPQElementPriority copy_priority,
+                                  FreePQElementPriority free_priority,
+                                  ComparePQElementPriorities compare_priorities,
+                                  const PQOptions* options);
+
+/**
+* pqCreateWithAllocator: Allocates a new empty priority queue, that allocates all of its memory (the queue
+* itself, its internal arrays, its iterators, and its copies made with pqCopy and pqSnapshot) with allocator.
+* Same as pqCreateWithOptions with only the allocator option set.
+*
+* @param allocator - The allocator of the queue. It is copied, and must stay usable (its context too)
+* 		until the queue, its copies and its iterators are all destroyed.
+* The rest of the parameters are the same as in pqCreate.
+* @return
+* 	NULL - if one of the parameters (or allocator's functions) is NULL, or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateWithAllocator(CopyPQElement copy_element,
+                                    FreePQElement free_element,
+                                    EqualPQElements equal_elements,
+                                    CopyPQElementPriority copy_priority,
+                                    FreePQElementPriority free_priority,
+                                    ComparePQElementPriorities compare_priorities,
+                                    const PQAllocator* allocator);
+
+/**
+* pqDefaultAllocator: Returns the allocator of queues (and pools) that weren't given one, which calls
+* malloc, realloc and free and has no context.
+*/
+const PQAllocator* pqDefaultAllocator(void);
+
+/**
+* pqCreateBounded: Allocates a new empty priority queue that holds at most capacity elements, and never grows
+* past them. All of its memory is allocated at creation (except for the copies of the elements).
+* The queue is double-ended (see PQOptions), so its lowest priority element is found in O(1) and evicted in
+* O(log n).
+* Once it is full, pqInsert rejects the new element with PQ_QUEUE_FULL or evicts the lowest priority element
+* to make room for it, by policy (see pqInsertEvict). The other insertions (pqInsertBatch, pqInsertOwned...)
+* never evict, and return PQ_QUEUE_FULL if the elements don't fit.
+*
+* @param capacity - The most elements the queue may hold. Must be positive.
+* @param policy - What an insertion into the full queue does (see PQBoundPolicy).
+* The rest of the parameters are the same as in pqCreate.
+* @return
+* 	NULL - if one of the parameters is NULL or invalid, or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateBounded(int capacity,
+                              PQBoundPolicy policy,
+                              CopyPQElement copy_element,
+                              FreePQElement free_element,
+                              EqualPQElements equal_elements,
+                              CopyPQElementPriority copy_priority,
+                              FreePQElementPriority free_priority,
+                              ComparePQElementPriorities compare_priorities);
+
+/**
+* pqCreateFromArray: Allocates a new priority queue holding copies of the given elements and priorities.
+* Same as creating a queue with pqCreate and inserting the elements with pqInsertBulk: the heap is built
+* once in O(n) instead of n separate insertions.
+*
+* @param elements - Array of n elements to insert. elements[i] gets the priority priorities[i].
+* @param priorities - Array of n priorities.
+* @param n - The number of elements in the arrays.
+* The rest of the parameters are the same as in pqCreate.
+* @return
+* 	NULL - if one of the parameters is NULL or invalid, or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateFromArray(CopyPQElement copy_element,
+                                FreePQElement free_element,
+                                EqualPQElements equal_elements,
+                                CopyPQElementPriority copy_priority,
+                                FreePQElementPriority free_priority,
+                                ComparePQElementPriorities compare_priorities,
+                                PQElement elements[],
+                                PQElementPriority priorities[],
+                                int n);
+
+/**
+* pqCreateInline: Allocates a new empty priority queue, that stores its elements and priorities by value.
+* The elements and priorities are plain values of a fixed size (no pointers to memory owned by them).
+* They are copied with memcpy into storage owned by the queue, so no copy or free functions are called
+* and nothing is allocated per inserted element.
+* The elements and priorities returned by pqGetFirst, pqGetNext and pqIterNext point into that storage,
+* and are valid only until the queue is changed.
+* pqInsertOwned and pqPopOwned are not supported (PQ_ERROR), and pqPop may only be called with NULL
+* element and priority: use pqPopInto to get the removed values.
+*
+* @param element_size - The size in bytes of each element. Must be positive.
+* @param priority_size - The size in bytes of each priority. Must be positive.
+* @param equal_elements - Function pointer to be used for comparing elements.
+* @param compare_priorities - Function pointer to be used for comparing priorities.
+* @return
+* 	NULL - if one of the parameters is NULL or invalid, or allocations failed.
+* 	A new priority queue in case of success.
+*/
+PriorityQueue pqCreateInline(int element_size,
+                             int priority_size,
+                             EqualPQElements equal_elements,
+                             ComparePQElementPriorities compare_priorities);
+
 /**
 * pqDestroy: Deallocates an existing priority queue. Clears all elements by using the
 * free functions.
@@ -117,8 +385,27 @@ PriorityQueue pqCreate(CopyPQElement copy_element,
 */
 void pqDestroy(PriorityQueue queue);
 
+/**
+* pqSetFreeBatch: Sets functions that free arrays of elements and priorities at once.
+* pqClear and pqDestroy free all the elements (and priorities) of the queue with a single call to
+* the batch function, instead of calling the free function once per element. All other operations
+* keep using the free functions given at initialization.
+* The arrays passed to the batch functions are owned by the queue, and must not be kept.
+*
+* @param queue - Target priority queue.
+* @param free_element_batch - Function freeing count elements. If NULL, free_element is used.
+* @param free_priority_batch - Function freeing count priorities. If NULL, free_priority is used.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ERROR if queue is an inline queue (see pqCreateInline), which has nothing to free.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqSetFreeBatch(PriorityQueue queue, FreePQElementBatch free_element_batch,
+                                   FreePQElementPriorityBatch free_priority_batch);
+
 /**
 * pqCopy: Creates a copy of target priority queue.
+* The copy is made in a single pass over the queue's storage, in O(size).
 * Iterator values for both priority queues are undefined after this operation.
 *
 * @param queue - Target priority queue.
@@ -128,6 +415,22 @@ void pqDestroy(PriorityQueue queue);
 */
 PriorityQueue pqCopy(PriorityQueue queue);
 
+/**
+* pqSnapshot: Creates a copy-on-write copy of target priority queue.
+* The snapshot shares the elements, priorities and internal arrays of queue (copying none of them), until
+* either of them is changed: the changed queue first gets its own copy of the storage, as in pqCopy.
+* Any number of snapshots may share the same storage. Both queues must still be destroyed with pqDestroy.
+* Because of that copy, every operation that changes a queue which shares its storage may also
+* return PQ_OUT_OF_MEMORY.
+* Iterator values for both priority queues are undefined after this operation.
+*
+* @param queue - Target priority queue.
+* @return
+* 	NULL if a NULL was sent or a memory allocation failed.
+* 	A Priority Queue containing the same elements as queue otherwise.
+*/
+PriorityQueue pqSnapshot(PriorityQueue queue);
+
 /**
 * pqGetSize: Returns the number of elements in a priority queue
 * @param queue - The priority queue which size is requested
@@ -137,6 +440,44 @@ PriorityQueue pqCopy(PriorityQueue queue);
 */
 int pqGetSize(PriorityQueue queue);
 
+/**
+* pqGetCapacity: Returns the number of elements that a priority queue can hold without expanding.
+* @param queue - The priority queue whose capacity is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the capacity of the priority queue.
+*/
+int pqGetCapacity(PriorityQueue queue);
+
+/**
+*   pqReserve: Makes sure the priority queue can hold capacity elements without expanding, allocating
+*   the room for all of them at once. Does nothing if the queue can already hold them.
+*   A bounded queue (see pqCreateBounded) reserves room for at most its bound.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to reserve room in.
+* @param capacity - The number of elements the queue should be able to hold.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ERROR if capacity is negative.
+* 	PQ_OUT_OF_MEMORY if an allocation failed.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqReserve(PriorityQueue queue, int capacity);
+
+/**
+*   pqShrinkToFit: Shrinks the capacity of the priority queue to its size (at least 1), giving back
+*   the memory of the unused elements.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to shrink.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_OUT_OF_MEMORY if the queue shares its storage with a snapshot (see pqSnapshot) and copying it failed.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqShrinkToFit(PriorityQueue queue);
+
 /**
 * pqContains: Checks if an element exists in the priority queue. The element will be
 * considered in the priority queue if one of the elements in the priority queue it determined equal
@@ -164,10 +505,103 @@ bool pqContains(PriorityQueue queue, PQElement element);
 * 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
 * 	PQ_OUT_OF_MEMORY if an allocation failed (Meaning the function for copying
 * 	an element failed)
+* 	PQ_QUEUE_FULL if the queue is bounded and full, and its policy rejected the element (see pqInsertEvict)
 * 	PQ_SUCCESS the paired elements had been inserted successfully
 */
 PriorityQueueResult pqInsert(PriorityQueue queue, PQElement element, PQElementPriority priority);
 
+/**
+*   pqInsertEvict: add a specified element with a specific priority, like pqInsert, to a bounded queue
+*   (see pqCreateBounded). If the queue is full and its policy is PQ_BOUND_EVICT_MIN, the lowest priority
+*   element is removed in O(log n) to make room, and handed to the caller. The new element is rejected instead
+*   if its priority isn't higher than the lowest priority in the queue.
+*   On an unbounded queue it is the same as pqInsert.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue for which to add the data element
+* @param element - The element which need to be added.
+* @param priority - The new priority to associate with the given element.
+* @param evicted_element - Set to the evicted element (NULL if none was evicted), which the caller is responsible
+* 		for freeing. If NULL, the evicted element is freed using the free function given at initialization.
+* @param evicted_priority - Set to the priority of the evicted element (NULL if none was evicted), which the
+* 		caller is responsible for freeing. If NULL, the priority is freed using the free function.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue, element or priority
+* 	PQ_ERROR if the queue is inline and evicted_element or evicted_priority isn't NULL.
+* 	PQ_OUT_OF_MEMORY if an allocation failed. Nothing is evicted in that case.
+* 	PQ_QUEUE_FULL if the queue is full and the element was rejected (by the policy, or for its priority).
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult pqInsertEvict(PriorityQueue queue, PQElement element, PQElementPriority priority,
+                                  PQElement* evicted_element, PQElementPriority* evicted_priority);
+
+/**
+*   pqInsertBatch: add n elements with their priorities, as if each was added with pqInsert, in array order
+*   (elements with equal priorities are removed in array order).
+*   The arguments are checked and room for all the elements is reserved once for the whole batch.
+*   The heap order is then restored once, by moving the new elements up or by rebuilding the heap in
+*   O(size + n), whichever is cheaper for the sizes of the batch and the queue.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue for which to add the data elements
+* @param elements - Array of n elements to add. elements[i] gets the priority priorities[i].
+* @param priorities - Array of n priorities.
+* @param n - The number of elements in the arrays.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters (or as one of the first n array entries)
+* 	PQ_ERROR if n is negative
+* 	PQ_OUT_OF_MEMORY if an allocation failed. No element is added in that case.
+* 	PQ_QUEUE_FULL if the queue is bounded (see pqCreateBounded) and the elements don't fit. No element is added.
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult pqInsertBatch(PriorityQueue queue, PQElement elements[], PQElementPriority priorities[], int n);
+
+/**
+*   pqInsertBulk: Same as pqInsertBatch.
+*/
+PriorityQueueResult pqInsertBulk(PriorityQueue queue, PQElement elements[], PQElementPriority priorities[], int n);
+
+/**
+*   pqInsertOwned: add a specified element with a specific priority, without copying them.
+*   The queue takes ownership of element and priority: they are not copied on insertion, and are freed
+*   with the free functions given at initialization when removed (unless taken back with pqPopOwned).
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue for which to add the data element
+* @param element - The element to add. Must not be used by the caller after a successful insertion.
+* @param priority - The priority to associate with the given element. Same as element.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_ERROR if queue is an inline queue (see pqCreateInline).
+* 	PQ_OUT_OF_MEMORY if an allocation failed. The caller still owns element and priority in that case.
+* 	PQ_QUEUE_FULL if the queue is bounded (see pqCreateBounded) and full. Same as PQ_OUT_OF_MEMORY.
+* 	PQ_SUCCESS the paired elements had been inserted successfully
+*/
+PriorityQueueResult pqInsertOwned(PriorityQueue queue, PQElement element, PQElementPriority priority);
+
+/**
+*   pqMeld: Moves all the elements of source (with their priorities) into destination, leaving source empty.
+*   The elements and priorities are moved, not copied, so the copy and free functions aren't called.
+*   Equal priorities are still removed by insertion order: the elements of source keep their order, and come
+*   after the equal elements that were already in destination.
+*   Takes O(n) time for the n elements of source, plus restoring the heap of destination, which takes the
+*   cheaper of O(n log(size)) and O(size). For a heap that melds in O(1), see pairing_heap.h.
+*   The iterators of both queues are undefined after this operation.
+*
+* @param destination - The priority queue to add the elements to.
+* @param source - The priority queue to take the elements from. Must have the same element equality, free
+*       and compare functions as destination (or the same element and priority sizes, if both are inline),
+*       and the same priority type (see PQOptions).
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_ERROR if the queues are the same queue, or their functions (or kinds) are different.
+* 	PQ_OUT_OF_MEMORY if an allocation failed. Both queues are left as they were in that case.
+* 	PQ_QUEUE_FULL if destination is bounded (see pqCreateBounded) and the elements don't fit. Same as
+* 	PQ_OUT_OF_MEMORY.
+* 	PQ_SUCCESS the elements had been moved successfully
+*/
+PriorityQueueResult pqMeld(PriorityQueue destination, PriorityQueue source);
+
 /**
 *	pqChangePriority: Changes a priority of specific element with a specific priority in the priority queue.
 *           If there are multiple same elements with same priority,
@@ -202,6 +636,99 @@ PriorityQueueResult pqChangePriority(PriorityQueue queue, PQElement element,
 */
 PriorityQueueResult pqRemove(PriorityQueue queue);
 
+/**
+*   pqPop: Removes the highest priority element from the priority queue, and hands it to the caller.
+*   The order is the same as in pqRemove, but the top is found and removed once, and the caller takes
+*   ownership of the queue's copies instead of having them freed: there is no need to copy the element
+*   returned from pqGetFirst before removing it.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to remove the element from.
+* @param element - Set to the removed element, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @param priority - Set to the priority of the removed element, which the caller is responsible for freeing.
+* 		If NULL, the priority is freed using the free function given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_ERROR if queue is an inline queue and element or priority isn't NULL.
+* 	PQ_SUCCESS the most prioritized element had been removed successfully.
+*/
+PriorityQueueResult pqPop(PriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   pqPopOwned: Removes the highest priority element from the priority queue, and hands it to the caller.
+*   Nothing is freed: the caller owns the returned element and priority, and is responsible for freeing them.
+*   Same as pqPop, except that both element and priority must be given.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to remove the element from.
+* @param element - Set to the removed element.
+* @param priority - Set to the priority of the removed element.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent to the function.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_ERROR if queue is an inline queue (see pqCreateInline).
+* 	PQ_SUCCESS the most prioritized element had been removed successfully.
+*/
+PriorityQueueResult pqPopOwned(PriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   pqRemoveMin: Removes the lowest priority element from the priority queue (the one pqPeekMin returns),
+*   and hands it to the caller, like pqPop.
+*   Takes O(log n) time in a double-ended queue (see PQOptions), and O(n) in any other queue.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to remove the element from.
+* @param element - Set to the removed element, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @param priority - Set to the priority of the removed element, which the caller is responsible for freeing.
+* 		If NULL, the priority is freed using the free function given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_ERROR if the queue is inline and element or priority isn't NULL.
+* 	PQ_OUT_OF_MEMORY if the queue shared its storage (see pqSnapshot) and copying it failed.
+* 	PQ_SUCCESS the lowest priority element had been removed successfully.
+*/
+PriorityQueueResult pqRemoveMin(PriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   pqPopBatch: Removes the k highest priority elements from the priority queue (or all of them, if it has
+*   fewer than k), and hands them to the caller in the order pqPop would have removed them.
+*   The arguments are checked, and the queue is shrunk and its iterators invalidated, once for the whole batch.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The priority queue to remove the elements from.
+* @param k - The number of elements to remove.
+* @param elements - Array of at least k entries, set to the removed elements, which the caller is responsible
+* 		for freeing. If NULL, the elements are freed using the free function given at initialization.
+* @param priorities - Array of at least k entries, set to the priorities of the removed elements, which the
+* 		caller is responsible for freeing. If NULL, the priorities are freed using the free function.
+* @return
+* 	-1 if a NULL was sent as queue, k is negative, the queue is inline and an array was sent (see pqPopInto),
+* 	or an allocation failed. No element is removed in that case.
+* 	Otherwise the number of removed elements.
+*/
+int pqPopBatch(PriorityQueue queue, int k, PQElement elements[], PQElementPriority priorities[]);
+
+/**
+*   pqPopInto: Removes the highest priority element from an inline priority queue (see pqCreateInline),
+*   and copies its element and priority into the given buffers.
+*   The order is the same as in pqRemove.
+*   Iterator's value is undefined after this operation.
+*
+* @param queue - The inline priority queue to remove the element from.
+* @param element_buffer - Buffer of element_size bytes the element is copied to. Ignored if NULL.
+* @param priority_buffer - Buffer of priority_size bytes the priority is copied to. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ERROR if queue isn't an inline queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_SUCCESS the most prioritized element had been removed successfully.
+*/
+PriorityQueueResult pqPopInto(PriorityQueue queue, void* element_buffer, void* priority_buffer);
+
 /**
 *   pqRemoveElement: Removes the highest priority element from the priority queue which have its value equal to element.
 *   If there are multiple elements with the same highest priority, the first inserted element should be removed first.
@@ -220,12 +747,76 @@ PriorityQueueResult pqRemove(PriorityQueue queue);
 */
 PriorityQueueResult pqRemoveElement(PriorityQueue queue, PQElement element);
 
+/**
+*   pqPeek: Returns the highest priority element of the priority queue (the one pqPop would remove)
+*   and its priority, without removing them.
+*   The iterators of the queue are not affected by this operation.
+*
+* @param queue - The priority queue to look at.
+* @param element - Set to the element, which still belongs to the queue. Ignored if NULL.
+* @param priority - Set to the priority of the element, which still belongs to the queue. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqPeek(PriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   pqPeekMin: Returns the lowest priority element of the priority queue (the one pqPop would remove last)
+*   and its priority, without removing them.
+*   Takes O(1) time in a double-ended queue (see PQOptions), and O(n) in any other queue.
+*   The iterators of the queue are not affected by this operation.
+*
+* @param queue - The priority queue to look at.
+* @param element - Set to the element, which still belongs to the queue. Ignored if NULL.
+* @param priority - Set to the priority of the element, which still belongs to the queue. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as queue.
+* 	PQ_ITEM_DOES_NOT_EXIST if the priority queue is empty.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult pqPeekMin(PriorityQueue queue, PQElement* element, PQElementPriority* priority);
+
+/**
+*   pqPeekTopK: Returns the k highest priority elements of the priority queue (or all of them, if it has
+*   fewer than k), in the order pqPop would remove them, without removing them.
+*   Takes O(k log k) time, whatever the size of the queue.
+*   The queue and its iterators are not affected by this operation.
+*
+* @param queue - The priority queue to look at.
+* @param k - The number of elements to return.
+* @param elements - Array of at least k entries, set to the elements, which still belong to the queue.
+* @param priorities - Array of at least k entries, set to the priorities of the elements, which still
+* 		belong to the queue. Ignored if NULL.
+* @return
+* 	-1 if a NULL was sent as queue or elements, k is negative or an allocation failed.
+* 	Otherwise the number of returned elements.
+*/
+int pqPeekTopK(PriorityQueue queue, int k, PQElement elements[], PQElementPriority priorities[]);
+
+/**
+*   pqCountHigherPriority: Returns the number of elements in the priority queue whose priority is higher
+*   than priority, in O(count) time. This is the number of elements that pqPop would return before an
+*   element with that priority.
+*   The iterators of the queue are not affected by this operation.
+*
+* @param queue - The priority queue to count the elements in.
+* @param priority - The priority to compare to.
+* @return
+* 	-1 if a NULL was sent or an allocation failed.
+* 	Otherwise the number of elements with a higher priority.
+*/
+int pqCountHigherPriority(PriorityQueue queue, PQElementPriority priority);
+
 /**
 *	pqGetFirst: Sets the internal iterator (also called current element) to
 *	the first element in the priority queue. The internal order derived from the priorities, and the tie-breaker between
 *   two equal priorities is the insertion order.
 *	Use this to start iterating over the priority queue.
 *	To continue iteration use pqGetNext
+*	Iterating doesn't change the queue: the iterator walks down the heap, so every step
+*	costs O(log n) and a whole traversal costs O(n log n).
 *
 * @param queue - The priority queue for which to set the iterator and return the first element.
 * @return
@@ -245,13 +836,50 @@ PQElement pqGetFirst(PriorityQueue queue);
 */
 PQElement pqGetNext(PriorityQueue queue);
 
+/**
+*	pqIterBegin: Creates an iterator over the priority queue. The iterator has its own position, so any number
+*	of iterators can walk the same queue at the same time, without using or changing the internal iterator.
+*	The iterator goes over the elements by the same order as pqGetFirst and pqGetNext.
+*	Every operation that changes the queue (insert, remove, change priority, clear) makes all of its
+*	iterators undefined, after which pqIterNext returns NULL. Operations that only read the queue don't.
+*
+* @param queue - The priority queue to iterate over.
+* @return
+* 	NULL if a NULL pointer was sent or an allocation failed.
+* 	A new iterator, positioned before the first element, otherwise.
+*/
+PQIterator pqIterBegin(PriorityQueue queue);
+
+/**
+*	pqIterNext: Advances the iterator to the next element and returns it.
+*	The first call returns the first element of the priority queue.
+*
+* @param iterator - The iterator to advance.
+* @return
+* 	NULL if reached the end of the priority queue, the queue changed since pqIterBegin,
+* 	or a NULL sent as argument.
+* 	The next element on the priority queue in case of success
+*/
+PQElement pqIterNext(PQIterator iterator);
+
+/**
+*	pqIterEnd: Deallocates an iterator. Every iterator created with pqIterBegin must be ended,
+*	and may still be ended after its priority queue was destroyed.
+*
+* @param iterator - The iterator to deallocate. If iterator is NULL nothing will be done.
+*/
+void pqIterEnd(PQIterator iterator);
+
 /**
 * pqClear: Removes all elements and priorities from target priority queue.
-* The elements are deallocated using the stored free functions.
+* The elements are deallocated using the stored free functions (or batch free functions, see
+* pqSetFreeBatch), in a single pass over the queue.
 * @param queue
 * 	Target priority queue to remove all element from.
 * @return
 * 	MAP_NULL_ARGUMENT - if a NULL pointer was sent.
+* 	PQ_OUT_OF_MEMORY - if the queue shares its storage with a snapshot (see pqSnapshot) and allocating
+* 		empty storage for it failed. The queue is unchanged in that case. The elements are never copied.
 * 	MAP_SUCCESS - Otherwise.
 */
 PriorityQueueResult pqClear(PriorityQueue queue);
@@ -265,4 +893,13 @@ PriorityQueueResult pqClear(PriorityQueue queue);
         iterator ;\
         iterator = pqGetNext(queue))
 
+/*!
+* Macro for iterating over the elements of a PQIterator from pqIterBegin.
+* Declares a new element variable for the loop. The iterator still needs to be ended with pqIterEnd.
+*/
+#define PQ_ITER_FOREACH(type, element, iterator) \
+    for(type element = (type) pqIterNext(iterator) ; \
+        element ;\
+        element = pqIterNext(iterator))
+
 #endif /* PRIORITY_QUEUE_H_ */
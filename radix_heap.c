@@ -0,0 +1,303 @@
+#include "radix_heap.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*----------------------------------------------------------------------
+                         Implementation constants
+ ----------------------------------------------------------------------*/
+
+// bucket 0 holds the keys equal to the last popped key, and bucket i (1 to 64) the keys whose highest bit
+// that differs from it is bit i - 1
+#define BUCKET_COUNT 65
+
+// The initial size of a bucket once it is first used
+#define INITIAL_BUCKET_SIZE 4
+
+// The factor by which a bucket's memory is expanded
+#define EXPAND_RATE 2
+
+// an element of the radix heap, with its key
+typedef struct EntryStruct {
+    unsigned long long key;
+    PQElement element;
+} Entry;
+
+// a bucket: the entries in it are entries[first] to entries[size - 1], in insertion order.
+// (only bucket 0 is popped from its beginning, the other buckets are always emptied at once)
+typedef struct BucketStruct {
+    Entry* entries;
+    int first;
+    int size;
+    int max_size;
+} Bucket;
+
+struct RadixHeap_t {
+    Bucket buckets[BUCKET_COUNT];
+
+    //number of elements in the radix heap
+    int size;
+
+    //the key of the last popped element (0 before the first pop). no key in the heap is smaller
+    unsigned long long last_key;
+
+    // function pointers that were defined in the header file
+    CopyPQElement copy_element;
+    FreePQElement free_element;
+};
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// returns the bucket of key: 0 if it is equal to last_key, otherwise one more than the
+// highest bit in which it differs from last_key
+static int bucketOf(unsigned long long key, unsigned long long last_key) {
+    unsigned long long difference = key ^ last_key;
+    int bucket = 0;
+    for(int shift = 32; shift > 0; shift /= 2) {
+        if(difference >> shift) {
+            difference >>= shift;
+            bucket += shift;
+        }
+    }
+    return difference == 0 ? bucket : bucket + 1;
+}
+
+// adds entry to the end of bucket, expanding it if needed
+static PriorityQueueResult bucketAppend(Bucket* bucket, Entry entry) {
+    if(bucket->size == bucket->max_size) {
+        int new_size = bucket->max_size == 0 ? INITIAL_BUCKET_SIZE : bucket->max_size * EXPAND_RATE;
+        Entry* new_entries = realloc(bucket->entries, new_size * sizeof(Entry));
+        if(new_entries == NULL) {
+            return PQ_OUT_OF_MEMORY;
+        }
+        bucket->entries = new_entries;
+        bucket->max_size = new_size;
+    }
+    bucket->entries[bucket->size++] = entry;
+    return PQ_SUCCESS;
+}
+
+// returns the entry that the next pop removes, without moving any entry: the first entry of bucket 0, or the
+// first entry with the smallest key in the lowest non empty bucket (entries with equal keys are always in
+// the same bucket, by insertion order).
+// NOTE: the heap must not be empty
+static const Entry* findMinimum(const RadixHeap heap) {
+    assert(heap->size > 0);
+    if(heap->buckets[0].first < heap->buckets[0].size) {
+        return &heap->buckets[0].entries[heap->buckets[0].first];
+    }
+
+    int lowest = 1;
+    while(heap->buckets[lowest].size == 0) {
+        lowest++;
+    }
+    const Bucket* bucket = &heap->buckets[lowest];
+    const Entry* minimum = &bucket->entries[0];
+    for(int i = 1; i < bucket->size; i++) {
+        if(bucket->entries[i].key < minimum->key) {
+            minimum = &bucket->entries[i];
+        }
+    }
+    return minimum;
+}
+
+// makes sure the smallest key in the heap is in bucket 0, by making it the last popped key and spreading
+// the lowest non empty bucket (where it is) into the lower buckets.
+// returns PQ_OUT_OF_MEMORY if a bucket couldn't expand, in which case the heap is left as it was
+// NOTE: the heap must not be empty
+static PriorityQueueResult bringMinimumToFront(RadixHeap heap) {
+    assert(heap->size > 0);
+    if(heap->buckets[0].first < heap->buckets[0].size) {
+        return PQ_SUCCESS;
+    }
+
+    int lowest = 1;
+    while(heap->buckets[lowest].size == 0) {
+        lowest++;
+    }
+    Bucket* bucket = &heap->buckets[lowest];
+    unsigned long long min_key = bucket->entries[0].key;
+    for(int i = 1; i < bucket->size; i++) {
+        if(bucket->entries[i].key < min_key) {
+            min_key = bucket->entries[i].key;
+        }
+    }
+
+    // every entry goes to a lower bucket, which has to have room for it before anything is moved
+    int counts[BUCKET_COUNT] = {0};
+    for(int i = 0; i < bucket->size; i++) {
+        counts[bucketOf(bucket->entries[i].key, min_key)]++;
+    }
+    for(int target = 0; target < lowest; target++) {
+        Bucket* target_bucket = &heap->buckets[target];
+        if(target_bucket->size + counts[target] > target_bucket->max_size) {
+            int new_size = target_bucket->size + counts[target];
+            Entry* new_entries = realloc(target_bucket->entries, new_size * sizeof(Entry));
+            if(new_entries == NULL) {
+                return PQ_OUT_OF_MEMORY;
+            }
+            target_bucket->entries = new_entries;
+            target_bucket->max_size = new_size;
+        }
+    }
+
+    // bucket 0 is empty, so its popped part can be dropped. the entries keep their order
+    heap->buckets[0].first = 0;
+    heap->buckets[0].size = 0;
+    heap->last_key = min_key;
+    for(int i = 0; i < bucket->size; i++) {
+        Bucket* target_bucket = &heap->buckets[bucketOf(bucket->entries[i].key, min_key)];
+        target_bucket->entries[target_bucket->size++] = bucket->entries[i];
+    }
+    bucket->size = 0;
+
+    return PQ_SUCCESS;
+}
+
+/*----------------------------------------------------------------------
+                        Radix heap functions
+ ----------------------------------------------------------------------*/
+
+RadixHeap rhCreate(CopyPQElement copy_element, FreePQElement free_element) {
+    // check for NULL parameters
+    if(copy_element == NULL || free_element == NULL) {
+        return NULL;
+    }
+
+    RadixHeap heap = malloc(sizeof(*heap));
+    if(heap == NULL) {
+        return NULL;
+    }
+
+    // the buckets are allocated when they are first used
+    for(int i = 0; i < BUCKET_COUNT; i++) {
+        heap->buckets[i].entries = NULL;
+        heap->buckets[i].first = 0;
+        heap->buckets[i].size = 0;
+        heap->buckets[i].max_size = 0;
+    }
+    heap->size = 0;
+    heap->last_key = 0;
+
+    // use the funcs given by the user
+    heap->copy_element = copy_element;
+    heap->free_element = free_element;
+
+    return heap;
+}
+
+void rhDestroy(RadixHeap heap) {
+    if(heap == NULL) {
+        return;
+    }
+
+    rhClear(heap);
+    for(int i = 0; i < BUCKET_COUNT; i++) {
+        free(heap->buckets[i].entries);
+    }
+    free(heap);
+}
+
+int rhGetSize(RadixHeap heap) {
+    if(heap == NULL) {
+        return -1;
+    }
+    return heap->size;
+}
+
+PriorityQueueResult rhInsert(RadixHeap heap, PQElement element, unsigned long long key) {
+    if(heap == NULL || element == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // the heap is monotone: a key below the last popped one would have to be removed in the past
+    if(key < heap->last_key) {
+        return PQ_ERROR;
+    }
+
+    PQElement new_element = heap->copy_element(element);
+    if(new_element == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    Entry entry = {key, new_element};
+    if(bucketAppend(&heap->buckets[bucketOf(key, heap->last_key)], entry) == PQ_OUT_OF_MEMORY) {
+        heap->free_element(new_element);
+        return PQ_OUT_OF_MEMORY;
+    }
+    heap->size++;
+
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult rhPeek(RadixHeap heap, PQElement* element, unsigned long long* key) {
+    if(heap == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(heap->size == 0) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    // the buckets are only spread by a pop, since that is what makes its key the last popped key
+    const Entry* minimum = findMinimum(heap);
+    if(element != NULL) {
+        *element = minimum->element;
+    }
+    if(key != NULL) {
+        *key = minimum->key;
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult rhPop(RadixHeap heap, PQElement* element, unsigned long long* key) {
+    if(heap == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+    if(heap->size == 0) {
+        return PQ_ITEM_DOES_NOT_EXIST;
+    }
+
+    if(bringMinimumToFront(heap) == PQ_OUT_OF_MEMORY) {
+        return PQ_OUT_OF_MEMORY;
+    }
+
+    // the entries of bucket 0 all have the last popped key, and are removed by insertion order
+    Bucket* front = &heap->buckets[0];
+    Entry removed = front->entries[front->first++];
+    if(front->first == front->size) {
+        front->first = 0;
+        front->size = 0;
+    }
+    heap->size--;
+
+    // the caller gets what it asked for, and the rest is freed
+    if(element != NULL) {
+        *element = removed.element;
+    } else {
+        heap->free_element(removed.element);
+    }
+    if(key != NULL) {
+        *key = removed.key;
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult rhClear(RadixHeap heap) {
+    if(heap == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    // the buckets keep their memory for the next insertions
+    for(int i = 0; i < BUCKET_COUNT; i++) {
+        Bucket* bucket = &heap->buckets[i];
+        for(int entry = bucket->first; entry < bucket->size; entry++) {
+            heap->free_element(bucket->entries[entry].element);
+        }
+        bucket->first = 0;
+        bucket->size = 0;
+    }
+    heap->size = 0;
+
+    return PQ_SUCCESS;
+}
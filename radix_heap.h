@@ -0,0 +1,117 @@
+#ifndef RADIX_HEAP_H
+#define RADIX_HEAP_H
+
+#include "priority_queue.h"
+
+/**
+* Radix Heap Container
+*
+* Implements a monotone priority queue with unsigned integer keys, for users that only ever pop
+* non-decreasing keys (timers, Dijkstra's shortest paths...). The element with the smallest key is
+* removed first, and elements with equal keys are removed by insertion order.
+* It uses the same element function types as the priority queue in priority_queue.h, but no priority
+* functions: the keys are compared as integers, without calling any function.
+*
+* The elements are kept in 65 buckets by the highest bit in which their key differs from the last popped
+* key (bucket 0 holds the keys equal to it). A pop takes the elements of the lowest non empty bucket,
+* and spreads them into lower buckets by the new last popped key. Every element only moves to lower
+* buckets, so insertions and pops take amortized O(log C) time, for keys of up to C.
+* A key that is smaller than the last popped key can't be inserted.
+*
+* The following functions are available:
+*   rhCreate		    - Creates a new empty radix heap
+*   rhDestroy		    - Deletes an existing radix heap and frees all resources
+*   rhGetSize		    - Returns the size of a given radix heap
+*   rhInsert		    - Insert an element with a given key to the radix heap
+*   rhPeek		        - Returns the element with the smallest key (and its key) without removing it
+*   rhPop		        - Removes the element with the smallest key and hands it to the caller
+*   rhClear		        - Clears the contents of the radix heap. Frees all the elements using the free function.
+*/
+
+/** Type for defining the radix heap */
+typedef struct RadixHeap_t *RadixHeap;
+
+/**
+* rhCreate: Allocates a new empty radix heap, whose last popped key is 0.
+*
+* @param copy_element - Function pointer to be used for copying data elements into the radix heap.
+* @param free_element - Function pointer to be used for removing data elements from the radix heap.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new radix heap in case of success.
+*/
+RadixHeap rhCreate(CopyPQElement copy_element, FreePQElement free_element);
+
+/**
+* rhDestroy: Deallocates an existing radix heap. Clears all elements by using the free function.
+*
+* @param heap - Target radix heap to be deallocated. If it is NULL nothing will be done
+*/
+void rhDestroy(RadixHeap heap);
+
+/**
+* rhGetSize: Returns the number of elements in a radix heap.
+* @param heap - The radix heap which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of elements in the radix heap.
+*/
+int rhGetSize(RadixHeap heap);
+
+/**
+*   rhInsert: add a specified element with a specific key.
+*
+* @param heap - The radix heap for which to add the data element
+* @param element - The element which need to be added. A copy of the element will be inserted
+*      as supplied by the copying function which is given at initialization.
+* @param key - The key of the element. Must not be smaller than the last popped key.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as one of the parameters
+* 	PQ_ERROR if key is smaller than the last popped key
+* 	PQ_OUT_OF_MEMORY if an allocation failed (Meaning the function for copying
+* 	an element failed)
+* 	PQ_SUCCESS the element had been inserted successfully
+*/
+PriorityQueueResult rhInsert(RadixHeap heap, PQElement element, unsigned long long key);
+
+/**
+*   rhPeek: Returns the element with the smallest key in the radix heap (the one rhPop would remove),
+*   and its key, without removing it.
+*
+* @param heap - The radix heap to look at.
+* @param element - Set to the element, which still belongs to the radix heap. Ignored if NULL.
+* @param key - Set to the key of the element. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as heap.
+* 	PQ_ITEM_DOES_NOT_EXIST if the radix heap is empty.
+* 	PQ_SUCCESS otherwise.
+*/
+PriorityQueueResult rhPeek(RadixHeap heap, PQElement* element, unsigned long long* key);
+
+/**
+*   rhPop: Removes the element with the smallest key from the radix heap, and hands it to the caller.
+*   Its key becomes the last popped key.
+*
+* @param heap - The radix heap to remove the element from.
+* @param element - Set to the removed element, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @param key - Set to the key of the removed element. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as heap.
+* 	PQ_ITEM_DOES_NOT_EXIST if the radix heap is empty.
+* 	PQ_SUCCESS the element had been removed successfully.
+*/
+PriorityQueueResult rhPop(RadixHeap heap, PQElement* element, unsigned long long* key);
+
+/**
+*   rhClear: Removes all elements from the radix heap. The elements are deallocated using the free
+*   function. The last popped key is kept.
+*
+* @param heap - Target radix heap to remove all element from.
+* @return
+* 	PQ_NULL_ARGUMENT - if a NULL pointer was sent.
+* 	PQ_SUCCESS - Otherwise.
+*/
+PriorityQueueResult rhClear(RadixHeap heap);
+
+#endif /* RADIX_HEAP_H */
@@ -1,6 +1,16 @@
+#include <stdint.h>
 #include <stdlib.h>
 #include "test_utilities.h"
 #include "priority_queue.h"
+#include "pq_generic.h"
+#include "pq_pool.h"
+#include "pq_simd.h"
+#include "concurrent_priority_queue.h"
+#include "multi_queue.h"
+#include "radix_heap.h"
+#include "timing_wheel.h"
+#include "pairing_heap.h"
+#include <pthread.h>
 
 #define PQ PriorityQueue
 
@@ -29,6 +39,31 @@ static bool equalIntsGeneric(PQElementPriority n1, PQElementPriority n2) {
     return *(int *) n1 == *(int *) n2;
 }
 
+static unsigned long hashIntGeneric(PQElement n) {
+    return (unsigned long) *(int *) n;
+}
+
+static PQElementPriority copyDoubleGeneric(PQElementPriority n) {
+    if (!n) {
+        return NULL;
+    }
+    double *copy = malloc(sizeof(*copy));
+    if (!copy) {
+        return NULL;
+    }
+    *copy = *(double *) n;
+    return copy;
+}
+
+static int compareDoublesGeneric(PQElementPriority n1, PQElementPriority n2) {
+    return (*(double *) n1 > *(double *) n2) - (*(double *) n1 < *(double *) n2);
+}
+
+
+// a queue of ints with int priorities, specialized with PQ_DECLARE
+#define compareIntValues(first, second) (((first) > (second)) - ((first) < (second)))
+PQ_DECLARE(IntPQ, int, int, compareIntValues)
+
 
 int *randInt() {
     int *num = malloc(sizeof(int));
@@ -42,6 +77,12 @@ PriorityQueue createPQ() {
     return pq;
 }
 
+PriorityQueue createHashedPQ() {
+    PriorityQueue pq = pqCreateHashed(copyIntGeneric, freeIntGeneric, equalIntsGeneric, hashIntGeneric,
+                                      copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    return pq;
+}
+
 PriorityQueue getSingleElementPQ() {
     PriorityQueue pq = createPQ();
     int *element = randInt();
@@ -461,6 +502,43 @@ bool testPQChangePriorityWOnlyChangesFirstOfMultipleSameElementsAndReinsertsIt()
 
 
 
+bool testPQChangePriorityRepeatedlyKeepsQueueOrdered() {
+    bool result = true;
+    PQ pq = createPQ();
+
+    int count = 100;
+    for (int i = 0; i < count; i++) {
+        pqInsert(pq, &i, &i);
+    }
+
+    // moves every element both up (to i + count) and down (to count - i) the queue
+    for (int i = 0; i < count; i++) {
+        int up_prio = i + count;
+        ASSERT_TEST(pqChangePriority(pq, &i, &i, &up_prio) == PQ_SUCCESS, destroy);
+    }
+    for (int i = 0; i < count; i += 2) {
+        int up_prio = i + count;
+        int down_prio = count - i;
+        ASSERT_TEST(pqChangePriority(pq, &i, &up_prio, &down_prio) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqGetSize(pq) == count, destroy);
+
+    // the odd elements kept their raised priorities, by descending order
+    for (int i = count - 1; i > 0; i -= 2) {
+        ASSERT_TEST((*(int *) pqGetFirst(pq)) == i, destroy);
+        pqRemove(pq);
+    }
+    // the even elements now have count - i as their priority, so they come out by ascending order
+    for (int i = 0; i < count; i += 2) {
+        ASSERT_TEST((*(int *) pqGetFirst(pq)) == i, destroy);
+        pqRemove(pq);
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
 /* ============= TESTING pqRemove ============= */
 
 bool testPQRemoveSampleNullArgument() {
@@ -506,6 +584,1533 @@ bool testPQRemoveStandardTest() {
 }
 
 
+bool testPQRemoveKeepsInsertionOrderOfEqualPriorities() {
+    bool result = true;
+    PQ pq = createPQ();
+
+    int prio = 7;
+    int low_prio = 3;
+    for (int i = 0; i < 20; i++) {
+        pqInsert(pq, &i, (i % 2 == 0) ? &prio : &low_prio);
+    }
+
+    // the even elements have the higher priority, and leave the queue by insertion order
+    for (int i = 0; i < 20; i += 2) {
+        ASSERT_TEST((*(int *) pqGetFirst(pq)) == i, destroy);
+        ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+    }
+    for (int i = 1; i < 20; i += 2) {
+        ASSERT_TEST((*(int *) pqGetFirst(pq)) == i, destroy);
+        ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqGetSize(pq) == 0, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqInsertOwned and pqPopOwned ============= */
+bool testPQInsertOwnedAndPopOwned() {
+    bool result = true;
+    PQ pq = createPQ();
+    int *element = NULL;
+    int *priority = NULL;
+
+    ASSERT_TEST(pqPopOwned(pq, (PQElement *) &element, (PQElementPriority *) &priority) == PQ_ITEM_DOES_NOT_EXIST,
+                destroy);
+    ASSERT_TEST(pqPopOwned(pq, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+
+    int *adopted[3];
+    for (int i = 0; i < 3; i++) {
+        adopted[i] = randInt();
+        int *prio = malloc(sizeof(int));
+        *prio = i;
+        ASSERT_TEST(pqInsertOwned(pq, adopted[i], prio) == PQ_SUCCESS, destroy);
+    }
+    int copied = 7;
+    pqInsert(pq, &copied, &copied);
+
+    // the copied element comes first, then the adopted ones which are handed back as the same pointers
+    ASSERT_TEST(pqPopOwned(pq, (PQElement *) &element, (PQElementPriority *) &priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(element != &copied && *element == copied, destroy);
+    free(element);
+    free(priority);
+    element = NULL;
+    priority = NULL;
+
+    ASSERT_TEST(pqPopOwned(pq, (PQElement *) &element, (PQElementPriority *) &priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(element == adopted[2] && *priority == 2, destroy);
+    ASSERT_TEST(pqGetSize(pq) == 2, destroy);
+
+    destroy:
+    free(element);
+    free(priority);
+    pqDestroy(pq); // frees the adopted elements that are still in the queue
+    return result;
+}
+
+/* ============= TESTING pqPop ============= */
+bool testPQPopReturnsElementsByPriority() {
+    bool result = true;
+    PQ pq = getMultipleElementPQ();
+    int *element = NULL;
+    int *priority = NULL;
+
+    ASSERT_TEST(pqPop(NULL, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+
+    int previous_priority = 50000;
+    for (int i = 0; i < 5; i++) {
+        int expected = *(int *) pqGetFirst(pq);
+        ASSERT_TEST(pqPop(pq, (PQElement *) &element, (PQElementPriority *) &priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*element == expected && *priority <= previous_priority, destroy);
+        previous_priority = *priority;
+        free(element);
+        free(priority);
+        element = NULL;
+        priority = NULL;
+    }
+
+    // only the element is wanted, the priority is freed by the queue
+    ASSERT_TEST(pqPop(pq, (PQElement *) &element, NULL) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(element != NULL, destroy);
+    ASSERT_TEST(pqPop(pq, NULL, NULL) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqGetSize(pq) == 3, destroy);
+
+    pqClear(pq);
+    ASSERT_TEST(pqPop(pq, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+
+    destroy:
+    free(element);
+    free(priority);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqCreateInline ============= */
+bool testPQInlineStoresValuesAndGrows() {
+    bool result = true;
+    PQ pq = pqCreateInline(sizeof(int), sizeof(int), equalIntsGeneric, compareIntsGeneric);
+    PQ copy = NULL;
+    int element = 0;
+    int priority = 0;
+
+    ASSERT_TEST(pqCreateInline(0, sizeof(int), equalIntsGeneric, compareIntsGeneric) == NULL, destroy);
+    ASSERT_TEST(pqCreateInline(sizeof(int), sizeof(int), NULL, compareIntsGeneric) == NULL, destroy);
+    ASSERT_TEST(pq != NULL, destroy);
+
+    // enough elements to make the queue expand (and move its storage) a few times
+    for (int i = 0; i < 100; i++) {
+        int value = i % 25;
+        ASSERT_TEST(pqInsert(pq, &value, &value) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqGetSize(pq) == 100, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(pq) == 24, destroy);
+    int target = 7;
+    ASSERT_TEST(pqContains(pq, &target), destroy);
+
+    // the values aren't handed out by pointer
+    int *pointer = NULL;
+    ASSERT_TEST(pqPop(pq, (PQElement *) &pointer, NULL) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqInsertOwned(pq, &element, &priority) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqPopInto(pq, &element, &priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(element == 24 && priority == 24, destroy);
+
+    int new_priority = 100;
+    ASSERT_TEST(pqChangePriority(pq, &target, &target, &new_priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(pq) == 7, destroy);
+
+    copy = pqCopy(pq);
+    ASSERT_TEST(copy != NULL && pqGetSize(copy) == 99, destroy);
+    ASSERT_TEST(pqRemoveElement(pq, &target) == PQ_SUCCESS, destroy);
+
+    // the copy keeps its own values, in the same order
+    ASSERT_TEST(pqPopInto(copy, &element, &priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(element == 7 && priority == 100, destroy);
+    int previous_priority = priority;
+    while (pqGetSize(copy) > 0) {
+        ASSERT_TEST(pqPopInto(copy, &element, NULL) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(element <= previous_priority, destroy);
+        previous_priority = element;
+    }
+    ASSERT_TEST(pqPopInto(copy, &element, &priority) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+
+    PQ regular = createPQ();
+    ASSERT_TEST(pqPopInto(regular, &element, &priority) == PQ_ERROR, destroy_regular);
+
+    destroy_regular:
+    pqDestroy(regular);
+    destroy:
+    pqDestroy(copy);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING PQ_DECLARE ============= */
+bool testPQDeclareKeepsSameOrderAsGenericQueue() {
+    bool result = true;
+    PQ pq = createPQ();
+    IntPQ int_pq = IntPQCreate();
+    IntPQ int_pq_copy = NULL;
+
+    ASSERT_TEST(IntPQGetSize(NULL) == -1, destroy);
+    ASSERT_TEST(IntPQInsert(NULL, 1, 1) == PQ_NULL_ARGUMENT, destroy);
+
+    // duplicates of elements and priorities, so the order of equal priorities is also compared
+    for (int i = 0; i < 200; i++) {
+        int element = rand() % 50;
+        int priority = rand() % 20;
+        pqInsert(pq, &element, &priority);
+        ASSERT_TEST(IntPQInsert(int_pq, element, priority) == PQ_SUCCESS, destroy);
+    }
+    int element = 7;
+    int old_priority = 3;
+    int new_priority = 19;
+    ASSERT_TEST(IntPQChangePriority(int_pq, element, old_priority, new_priority) ==
+                pqChangePriority(pq, &element, &old_priority, &new_priority), destroy);
+    element = 11;
+    ASSERT_TEST(IntPQRemoveElement(int_pq, element) == pqRemoveElement(pq, &element), destroy);
+    ASSERT_TEST(IntPQContains(int_pq, element) == pqContains(pq, &element), destroy);
+    ASSERT_TEST(IntPQGetSize(int_pq) == pqGetSize(pq), destroy);
+
+    // the iterators go over the elements by the same order
+    int *generic_iterator = pqGetFirst(pq);
+    PQ_GENERIC_FOREACH(IntPQ, int, iterator, int_pq) {
+        ASSERT_TEST(generic_iterator != NULL && *iterator == *generic_iterator, destroy);
+        generic_iterator = pqGetNext(pq);
+    }
+    ASSERT_TEST(generic_iterator == NULL, destroy);
+
+    int_pq_copy = IntPQCopy(int_pq);
+    ASSERT_TEST(int_pq_copy != NULL, destroy);
+    while (pqGetSize(pq) > 0) {
+        int expected = *(int *) pqGetFirst(pq);
+        int popped_element = -1;
+        int popped_priority = -1;
+        ASSERT_TEST(IntPQPop(int_pq, &popped_element, &popped_priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(popped_element == expected, destroy);
+        ASSERT_TEST(*IntPQGetFirst(int_pq_copy) == expected, destroy);
+        IntPQRemove(int_pq_copy);
+        pqRemove(pq);
+    }
+    ASSERT_TEST(IntPQPop(int_pq, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+    ASSERT_TEST(IntPQGetSize(int_pq_copy) == 0, destroy);
+
+    destroy:
+    IntPQDestroy(int_pq_copy);
+    IntPQDestroy(int_pq);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqInsertBulk ============= */
+bool testPQInsertBulkMatchesSeparateInserts() {
+    bool result = true;
+    PQ pq = createPQ();
+    PQ bulk_pq = NULL;
+    int values[300];
+    int priorities[300];
+    PQElement element_pointers[300];
+    PQElementPriority priority_pointers[300];
+
+    // duplicates of priorities, so the insertion order of equal priorities is also compared
+    for (int i = 0; i < 300; i++) {
+        values[i] = i;
+        priorities[i] = rand() % 40;
+        element_pointers[i] = &values[i];
+        priority_pointers[i] = &priorities[i];
+    }
+
+    ASSERT_TEST(pqInsertBulk(NULL, element_pointers, priority_pointers, 1) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqInsertBulk(pq, element_pointers, priority_pointers, -1) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqInsertBulk(pq, NULL, NULL, 0) == PQ_SUCCESS && pqGetSize(pq) == 0, destroy);
+
+    // half is built from the array, the other half is added to the existing elements
+    bulk_pq = pqCreateFromArray(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric, freeIntGeneric,
+                                compareIntsGeneric, element_pointers, priority_pointers, 150);
+    ASSERT_TEST(bulk_pq != NULL && pqGetSize(bulk_pq) == 150, destroy);
+    ASSERT_TEST(pqInsertBulk(bulk_pq, element_pointers + 150, priority_pointers + 150, 150) == PQ_SUCCESS, destroy);
+    for (int i = 0; i < 300; i++) {
+        pqInsert(pq, &values[i], &priorities[i]);
+    }
+    ASSERT_TEST(pqGetSize(bulk_pq) == 300, destroy);
+
+    while (pqGetSize(pq) > 0) {
+        ASSERT_TEST(*(int *) pqGetFirst(bulk_pq) == *(int *) pqGetFirst(pq), destroy);
+        pqRemove(bulk_pq);
+        pqRemove(pq);
+    }
+    ASSERT_TEST(pqGetSize(bulk_pq) == 0, destroy);
+
+    destroy:
+    pqDestroy(bulk_pq);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqInsertBatch and pqPopBatch ============= */
+bool testPQBatchesMatchSeparateInsertsAndPops() {
+    bool result = true;
+    PQ pq = createPQ();
+    PQ batch_pq = createPQ();
+    int values[500];
+    int priorities[500];
+    PQElement element_pointers[500];
+    PQElementPriority priority_pointers[500];
+    PQElement popped_elements[64];
+    PQElementPriority popped_priorities[64];
+    int popped = 0;
+
+    for (int i = 0; i < 500; i++) {
+        values[i] = i;
+        priorities[i] = rand() % 60;
+        element_pointers[i] = &values[i];
+        priority_pointers[i] = &priorities[i];
+    }
+
+    ASSERT_TEST(pqPopBatch(NULL, 1, NULL, NULL) == -1, destroy);
+    ASSERT_TEST(pqPopBatch(batch_pq, -1, NULL, NULL) == -1, destroy);
+    ASSERT_TEST(pqPopBatch(batch_pq, 5, popped_elements, popped_priorities) == 0, destroy);
+
+    // a large batch into an empty queue (rebuilt at once), then small batches into a large queue (moved up)
+    ASSERT_TEST(pqInsertBatch(batch_pq, element_pointers, priority_pointers, 400) == PQ_SUCCESS, destroy);
+    for (int i = 400; i < 500; i += 10) {
+        ASSERT_TEST(pqInsertBatch(batch_pq, element_pointers + i, priority_pointers + i, 10) == PQ_SUCCESS,
+                    destroy);
+    }
+    for (int i = 0; i < 500; i++) {
+        pqInsert(pq, &values[i], &priorities[i]);
+    }
+    ASSERT_TEST(pqGetSize(batch_pq) == 500, destroy);
+
+    // batches of different sizes come out in the same order as separate pops
+    for (int k = 1; pqGetSize(pq) > 0; k = k % 64 + 7) {
+        popped = pqPopBatch(batch_pq, k, popped_elements, popped_priorities);
+        ASSERT_TEST(popped == (k < pqGetSize(pq) ? k : pqGetSize(pq)), destroy);
+        for (int i = 0; i < popped; i++) {
+            ASSERT_TEST(*(int *) popped_elements[i] == *(int *) pqGetFirst(pq), destroy);
+            pqRemove(pq);
+        }
+        for (int i = 0; i < popped; i++) {
+            freeIntGeneric(popped_elements[i]);
+            freeIntGeneric(popped_priorities[i]);
+        }
+        popped = 0;
+    }
+    ASSERT_TEST(pqGetSize(batch_pq) == 0, destroy);
+
+    // without arrays the removed elements are freed by the queue
+    ASSERT_TEST(pqInsertBatch(batch_pq, element_pointers, priority_pointers, 20) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqPopBatch(batch_pq, 100, NULL, NULL) == 20 && pqGetSize(batch_pq) == 0, destroy);
+
+    destroy:
+    for (int i = 0; i < popped; i++) {
+        freeIntGeneric(popped_elements[i]);
+        freeIntGeneric(popped_priorities[i]);
+    }
+    pqDestroy(batch_pq);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqPeekTopK ============= */
+bool testPQPeekTopKMatchesPopOrderWithoutChangingQueue() {
+    bool result = true;
+    PQ pq = createPQ();
+    PQ copy = NULL;
+    PQElement top[60];
+    PQElementPriority top_priorities[60];
+
+    ASSERT_TEST(pqPeekTopK(NULL, 1, top, NULL) == -1, destroy);
+    ASSERT_TEST(pqPeekTopK(pq, 1, NULL, NULL) == -1, destroy);
+    ASSERT_TEST(pqPeekTopK(pq, 10, top, NULL) == 0, destroy);
+    for (int i = 0; i < 200; i++) {
+        int priority = rand() % 30;
+        pqInsert(pq, &i, &priority);
+    }
+
+    // the internal iterator keeps its place
+    pqGetFirst(pq);
+    ASSERT_TEST(pqPeekTopK(pq, 50, top, top_priorities) == 50 && pqGetSize(pq) == 200, destroy);
+    ASSERT_TEST(pqGetNext(pq) == top[1], destroy);
+
+    copy = pqCopy(pq);
+    ASSERT_TEST(copy != NULL, destroy);
+    for (int i = 0; i < 50; i++) {
+        ASSERT_TEST(*(int *) top[i] == *(int *) pqGetFirst(copy), destroy);
+        ASSERT_TEST(i == 0 || compareIntsGeneric(top_priorities[i - 1], top_priorities[i]) >= 0, destroy);
+        pqRemove(copy);
+    }
+    pqClear(pq);
+    for (int i = 0; i < 3; i++) {
+        pqInsert(pq, &i, &i);
+    }
+    ASSERT_TEST(pqPeekTopK(pq, 60, top, NULL) == 3 && *(int *) top[0] == 2 && *(int *) top[2] == 0, destroy);
+
+    destroy:
+    pqDestroy(copy);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING double-ended queues ============= */
+bool testPQDoubleEndedMatchesRegularQueueAtBothEnds() {
+    bool result = true;
+    PQOptions options = {0};
+    options.double_ended = true;
+    PQ pq = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric, freeIntGeneric,
+                                compareIntsGeneric, &options);
+    PQ regular_pq = createPQ();
+    PQElement top[3000];
+    PQElement regular_top[3000];
+    int *element = NULL;
+    int *priority = NULL;
+
+    ASSERT_TEST(pq != NULL && regular_pq != NULL, destroy);
+    ASSERT_TEST(pqPeekMin(NULL, NULL, NULL) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqPeekMin(pq, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+    ASSERT_TEST(pqRemoveMin(pq, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+
+    // the same random operations on both queues, with both ends compared after each one
+    for (int step = 0; step < 3000; step++) {
+        int value = rand() % 100;
+        int priority_value = rand() % 50;
+        int new_priority = rand() % 50;
+        int operation = rand() % 10;
+        if (operation < 5 || pqGetSize(regular_pq) == 0) {
+            pqInsert(pq, &value, &priority_value);
+            pqInsert(regular_pq, &value, &priority_value);
+        } else if (operation == 5) {
+            pqRemove(pq);
+            pqRemove(regular_pq);
+        } else if (operation == 6) {
+            ASSERT_TEST(pqRemoveMin(pq, (PQElement *) &element, (PQElementPriority *) &priority) == PQ_SUCCESS,
+                        destroy);
+            PQElement regular_element;
+            pqPeekMin(regular_pq, &regular_element, NULL);
+            ASSERT_TEST(*element == *(int *) regular_element, destroy);
+            pqRemoveMin(regular_pq, NULL, NULL);
+            free(element);
+            free(priority);
+            element = NULL;
+            priority = NULL;
+        } else if (operation < 9) {
+            pqChangePriority(pq, &value, &priority_value, &new_priority);
+            pqChangePriority(regular_pq, &value, &priority_value, &new_priority);
+        } else {
+            pqRemoveElement(pq, &value);
+            pqRemoveElement(regular_pq, &value);
+        }
+
+        ASSERT_TEST(pqGetSize(pq) == pqGetSize(regular_pq), destroy);
+        if (pqGetSize(pq) > 0) {
+            PQElement min_element;
+            PQElement regular_min_element;
+            pqPeekMin(pq, &min_element, NULL);
+            pqPeekMin(regular_pq, &regular_min_element, NULL);
+            ASSERT_TEST(*(int *) min_element == *(int *) regular_min_element, destroy);
+            ASSERT_TEST(*(int *) pqGetFirst(pq) == *(int *) pqGetFirst(regular_pq), destroy);
+            ASSERT_TEST(pqCountHigherPriority(pq, &priority_value) ==
+                        pqCountHigherPriority(regular_pq, &priority_value), destroy);
+        }
+    }
+
+    // a batch into an empty queue rebuilds the whole min-max heap at once
+    int values[300];
+    PQElement value_pointers[300];
+    for (int i = 0; i < 300; i++) {
+        values[i] = rand() % 50;
+        value_pointers[i] = &values[i];
+    }
+    pqClear(pq);
+    pqClear(regular_pq);
+    ASSERT_TEST(pqInsertBatch(pq, value_pointers, value_pointers, 300) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqInsertBatch(regular_pq, value_pointers, value_pointers, 300) == PQ_SUCCESS, destroy);
+
+    // iterating and walking the top elements follow the same order
+    int size = pqGetSize(pq);
+    ASSERT_TEST(size <= 3000, destroy);
+    ASSERT_TEST(pqPeekTopK(pq, size, top, NULL) == size, destroy);
+    ASSERT_TEST(pqPeekTopK(regular_pq, size, regular_top, NULL) == size, destroy);
+    PQElement iterated = pqGetFirst(pq);
+    for (int i = 0; i < size; i++) {
+        ASSERT_TEST(*(int *) top[i] == *(int *) regular_top[i] && iterated == top[i], destroy);
+        iterated = pqGetNext(pq);
+    }
+    ASSERT_TEST(iterated == NULL, destroy);
+
+    destroy:
+    free(element);
+    free(priority);
+    pqDestroy(pq);
+    pqDestroy(regular_pq);
+    return result;
+}
+
+/* ============= TESTING d-ary queues ============= */
+bool testPQArityQueuesMatchBinaryQueue() {
+    bool result = true;
+    PQOptions options = {0};
+    PQ pqs[2] = {NULL, NULL};
+    PQ copy = NULL;
+    PQ binary_pq = createPQ();
+    PQElement top[2000];
+    PQElement binary_top[2000];
+
+    // arities outside 2 to 8, and double-ended queues that aren't binary, are rejected
+    options.arity = 1;
+    ASSERT_TEST(pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                    freeIntGeneric, compareIntsGeneric, &options) == NULL, destroy);
+    options.arity = 9;
+    ASSERT_TEST(pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                    freeIntGeneric, compareIntsGeneric, &options) == NULL, destroy);
+    options.arity = 4;
+    options.double_ended = true;
+    ASSERT_TEST(pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                    freeIntGeneric, compareIntsGeneric, &options) == NULL, destroy);
+    options.double_ended = false;
+
+    options.arity = 4;
+    pqs[0] = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                 freeIntGeneric, compareIntsGeneric, &options);
+    options.arity = 8;
+    pqs[1] = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                 freeIntGeneric, compareIntsGeneric, &options);
+    ASSERT_TEST(pqs[0] != NULL && pqs[1] != NULL && binary_pq != NULL, destroy);
+
+    // the same random operations on all queues, with their tops compared after each one
+    for (int step = 0; step < 2000; step++) {
+        int value = rand() % 100;
+        int priority_value = rand() % 50;
+        int new_priority = rand() % 50;
+        int operation = rand() % 10;
+        for (int i = 0; i < 3; i++) {
+            PQ pq = i < 2 ? pqs[i] : binary_pq;
+            if (operation < 5) {
+                pqInsert(pq, &value, &priority_value);
+            } else if (operation < 7) {
+                pqRemove(pq);
+            } else if (operation < 9) {
+                pqChangePriority(pq, &value, &priority_value, &new_priority);
+            } else {
+                pqRemoveElement(pq, &value);
+            }
+        }
+        for (int i = 0; i < 2; i++) {
+            ASSERT_TEST(pqGetSize(pqs[i]) == pqGetSize(binary_pq), destroy);
+            if (pqGetSize(binary_pq) > 0) {
+                ASSERT_TEST(*(int *) pqGetFirst(pqs[i]) == *(int *) pqGetFirst(binary_pq), destroy);
+                ASSERT_TEST(pqCountHigherPriority(pqs[i], &priority_value) ==
+                            pqCountHigherPriority(binary_pq, &priority_value), destroy);
+            }
+        }
+    }
+
+    // a batch rebuilds the whole heap at once, and a copy keeps the arity
+    int values[300];
+    PQElement value_pointers[300];
+    for (int i = 0; i < 300; i++) {
+        values[i] = rand() % 50;
+        value_pointers[i] = &values[i];
+    }
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TEST(pqInsertBatch(pqs[i], value_pointers, value_pointers, 300) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqInsertBatch(binary_pq, value_pointers, value_pointers, 300) == PQ_SUCCESS, destroy);
+    copy = pqCopy(pqs[1]);
+    ASSERT_TEST(copy != NULL, destroy);
+    pqDestroy(pqs[1]);
+    pqs[1] = copy;
+    copy = NULL;
+
+    int size = pqGetSize(binary_pq);
+    ASSERT_TEST(size <= 2000, destroy);
+    ASSERT_TEST(pqPeekTopK(binary_pq, size, binary_top, NULL) == size, destroy);
+    for (int i = 0; i < 2; i++) {
+        ASSERT_TEST(pqPeekTopK(pqs[i], size, top, NULL) == size, destroy);
+        PQElement iterated = pqGetFirst(pqs[i]);
+        for (int j = 0; j < size; j++) {
+            ASSERT_TEST(*(int *) top[j] == *(int *) binary_top[j] && iterated == top[j], destroy);
+            iterated = pqGetNext(pqs[i]);
+        }
+        ASSERT_TEST(iterated == NULL, destroy);
+    }
+    for (int j = 0; j < size; j++) {
+        PQElement element = pqGetFirst(binary_pq);
+        for (int i = 0; i < 2; i++) {
+            ASSERT_TEST(*(int *) pqGetFirst(pqs[i]) == *(int *) element, destroy);
+            pqRemove(pqs[i]);
+        }
+        pqRemove(binary_pq);
+    }
+
+    destroy:
+    pqDestroy(copy);
+    pqDestroy(pqs[0]);
+    pqDestroy(pqs[1]);
+    pqDestroy(binary_pq);
+    return result;
+}
+
+/* ============= TESTING primitive priorities ============= */
+bool testPQPrimitivePrioritiesMatchCustomQueue() {
+    bool result = true;
+    PQOptions options = {0};
+    PQ pqs[4] = {NULL, NULL, NULL, NULL};
+    PQ custom_pq = createPQ();
+    PQ custom_double_pq = pqCreate(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyDoubleGeneric,
+                                   freeIntGeneric, compareDoublesGeneric);
+    int32_t ints[100];
+    float floats[100];
+    double doubles[100];
+    const void *arrays[3] = {ints, floats, doubles};
+
+    // every kernel level the CPU has finds the same values as the scalar kernels
+    ASSERT_TEST(pqSimdKernels(PQ_PRIORITY_CUSTOM, PQ_SIMD_SCALAR) == NULL, destroy);
+    for (int level = PQ_SIMD_SCALAR; level <= (int) pqSimdBestLevel(); level++) {
+        for (int trial = 0; trial < 200; trial++) {
+            for (int i = 0; i < 100; i++) {
+                ints[i] = rand() % 20 - 10;
+                floats[i] = (float) ints[i];
+                doubles[i] = ints[i];
+            }
+            int mask_count = 1 + rand() % PQ_SIMD_MAX_MASK_COUNT;
+            int offset = rand() % 8;
+            for (int type = PQ_PRIORITY_INT32; type <= PQ_PRIORITY_DOUBLE; type++) {
+                const PQSimdKernels *kernels = pqSimdKernels(type, level);
+                const PQSimdKernels *scalar = pqSimdKernels(type, PQ_SIMD_SCALAR);
+                size_t size = type == PQ_PRIORITY_DOUBLE ? sizeof(double) : sizeof(int32_t);
+                const char *values = (const char *) arrays[type - PQ_PRIORITY_INT32] + offset * size;
+                ASSERT_TEST(kernels != NULL && scalar != NULL, destroy);
+                ASSERT_TEST(kernels->maximumMask(values, mask_count) == scalar->maximumMask(values, mask_count),
+                            destroy);
+            }
+        }
+    }
+
+    // primitive priorities don't need a compare function, but custom ones do
+    options.priority_type = PQ_PRIORITY_CUSTOM;
+    ASSERT_TEST(pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                    freeIntGeneric, NULL, &options) == NULL, destroy);
+    options.priority_type = (PQPriorityType) (PQ_PRIORITY_DOUBLE + 1);
+    ASSERT_TEST(pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                    freeIntGeneric, compareIntsGeneric, &options) == NULL, destroy);
+
+    // int32 priorities with every kind of child search, and double priorities in an 8-ary heap
+    options.priority_type = PQ_PRIORITY_INT32;
+    for (int i = 0; i < 3; i++) {
+        options.arity = 2 << i;
+        pqs[i] = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                     freeIntGeneric, NULL, &options);
+    }
+    options.priority_type = PQ_PRIORITY_DOUBLE;
+    pqs[3] = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyDoubleGeneric,
+                                 freeIntGeneric, NULL, &options);
+    ASSERT_TEST(pqs[0] != NULL && pqs[1] != NULL && pqs[2] != NULL && pqs[3] != NULL, destroy);
+    ASSERT_TEST(custom_pq != NULL && custom_double_pq != NULL, destroy);
+
+    // the same random operations on all queues, with both of their ends compared after each one
+    for (int step = 0; step < 3000; step++) {
+        int value = rand() % 100;
+        int priority_value = rand() % 50 - 25;
+        int new_priority = rand() % 50 - 25;
+        double double_priority = priority_value + 0.25;
+        double new_double_priority = new_priority + 0.25;
+        int operation = rand() % 10;
+        for (int i = 0; i < 5; i++) {
+            PQ pq = i < 4 ? pqs[i] : custom_pq;
+            bool is_double = i == 3;
+            PQElementPriority priority = is_double ? (PQElementPriority) &double_priority : &priority_value;
+            PQElementPriority changed = is_double ? (PQElementPriority) &new_double_priority : &new_priority;
+            if (operation < 5) {
+                pqInsert(pq, &value, priority);
+                if (is_double) {
+                    pqInsert(custom_double_pq, &value, priority);
+                }
+            } else if (operation == 5) {
+                pqRemove(pq);
+                if (is_double) {
+                    pqRemove(custom_double_pq);
+                }
+            } else if (operation == 6) {
+                pqRemoveMin(pq, NULL, NULL);
+                if (is_double) {
+                    pqRemoveMin(custom_double_pq, NULL, NULL);
+                }
+            } else if (operation < 9) {
+                pqChangePriority(pq, &value, priority, changed);
+                if (is_double) {
+                    pqChangePriority(custom_double_pq, &value, priority, changed);
+                }
+            } else {
+                pqRemoveElement(pq, &value);
+                if (is_double) {
+                    pqRemoveElement(custom_double_pq, &value);
+                }
+            }
+        }
+
+        ASSERT_TEST(pqGetSize(custom_double_pq) == pqGetSize(custom_pq), destroy);
+        for (int i = 0; i < 4; i++) {
+            PQ expected_pq = i == 3 ? custom_double_pq : custom_pq;
+            ASSERT_TEST(pqGetSize(pqs[i]) == pqGetSize(expected_pq), destroy);
+            if (pqGetSize(expected_pq) > 0) {
+                PQElement min_element;
+                PQElement expected_min_element;
+                pqPeekMin(pqs[i], &min_element, NULL);
+                pqPeekMin(expected_pq, &expected_min_element, NULL);
+                ASSERT_TEST(*(int *) min_element == *(int *) expected_min_element, destroy);
+                ASSERT_TEST(*(int *) pqGetFirst(pqs[i]) == *(int *) pqGetFirst(expected_pq), destroy);
+            }
+        }
+    }
+
+    destroy:
+    for (int i = 0; i < 4; i++) {
+        pqDestroy(pqs[i]);
+    }
+    pqDestroy(custom_pq);
+    pqDestroy(custom_double_pq);
+    return result;
+}
+
+/* ============= TESTING pqMeld ============= */
+static int counted_copies = 0;
+
+static PQElement copyCountedInt(PQElement n) {
+    counted_copies++;
+    return copyIntGeneric(n);
+}
+
+bool testPQMeldMovesElementsWithoutCopying() {
+    bool result = true;
+    PQ destination = pqCreate(copyCountedInt, freeIntGeneric, equalIntsGeneric, copyCountedInt, freeIntGeneric,
+                              compareIntsGeneric);
+    PQ source = pqCreate(copyCountedInt, freeIntGeneric, equalIntsGeneric, copyCountedInt, freeIntGeneric,
+                         compareIntsGeneric);
+    PQ all = createPQ();
+    PQOptions options = {0};
+    options.priority_type = PQ_PRIORITY_INT32;
+    PQ other_kind = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                        freeIntGeneric, NULL, &options);
+    PQ small = pqCreateBounded(60, PQ_BOUND_REJECT, copyCountedInt, freeIntGeneric, equalIntsGeneric,
+                               copyCountedInt, freeIntGeneric, compareIntsGeneric);
+    PQ snapshot = NULL;
+
+    ASSERT_TEST(destination != NULL && source != NULL && all != NULL && other_kind != NULL && small != NULL,
+                destroy);
+    for (int i = 0; i < 50; i++) {
+        int destination_value = i;
+        int source_value = 100 + i;
+        int priority = i % 10;
+        ASSERT_TEST(pqInsert(destination, &destination_value, &priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsert(all, &destination_value, &priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsert(source, &source_value, &priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsert(small, &destination_value, &priority) == PQ_SUCCESS, destroy);
+    }
+    for (int i = 0; i < 50; i++) {
+        int source_value = 100 + i;
+        int priority = i % 10;
+        ASSERT_TEST(pqInsert(all, &source_value, &priority) == PQ_SUCCESS, destroy);
+    }
+
+    // queues that don't free or compare the same way can't be melded, and nothing moves
+    ASSERT_TEST(pqMeld(NULL, source) == PQ_NULL_ARGUMENT && pqMeld(destination, NULL) == PQ_NULL_ARGUMENT,
+                destroy);
+    ASSERT_TEST(pqMeld(destination, destination) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqMeld(destination, other_kind) == PQ_ERROR, destroy);
+    ASSERT_TEST(pqMeld(small, source) == PQ_QUEUE_FULL, destroy);
+    ASSERT_TEST(pqGetSize(small) == 50 && pqGetSize(source) == 50, destroy);
+
+    // the elements move without a single copy (only source's snapshot makes source copy its elements first)
+    snapshot = pqSnapshot(source);
+    ASSERT_TEST(snapshot != NULL, destroy);
+    int copies_before_meld = counted_copies;
+    ASSERT_TEST(pqMeld(destination, source) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqGetSize(destination) == 100 && pqGetSize(source) == 0 && pqGetSize(snapshot) == 50, destroy);
+    ASSERT_TEST(counted_copies - copies_before_meld == 100, destroy);
+    copies_before_meld = counted_copies;
+    pqDestroy(snapshot);
+    snapshot = NULL;
+    pqClear(source);
+    int source_value = 7;
+    int source_priority = 3;
+    ASSERT_TEST(pqInsert(source, &source_value, &source_priority) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqMeld(destination, source) == PQ_SUCCESS && pqGetSize(source) == 0, destroy);
+    ASSERT_TEST(counted_copies - copies_before_meld == 2, destroy);
+    ASSERT_TEST(pqInsert(all, &source_value, &source_priority) == PQ_SUCCESS, destroy);
+
+    // the melded queue removes its elements like a queue that got all the insertions, in the same order
+    while (pqGetSize(all) > 0) {
+        ASSERT_TEST(pqGetSize(destination) == pqGetSize(all), destroy);
+        ASSERT_TEST(*(int *) pqGetFirst(destination) == *(int *) pqGetFirst(all), destroy);
+        pqRemove(destination);
+        pqRemove(all);
+    }
+    ASSERT_TEST(pqGetSize(destination) == 0, destroy);
+
+    destroy:
+    pqDestroy(snapshot);
+    pqDestroy(destination);
+    pqDestroy(source);
+    pqDestroy(all);
+    pqDestroy(other_kind);
+    pqDestroy(small);
+    return result;
+}
+
+/* ============= TESTING pairing heaps ============= */
+bool testPairingHeapMatchesPriorityQueueAndMelds() {
+    bool result = true;
+    PairingHeap heaps[2] = {NULL, NULL};
+    PQ expected[2] = {createPQ(), createPQ()};
+    PHNode nodes[2000];
+    int priorities[2000];
+    bool alive[2000] = {false};
+    int *element = NULL;
+    int *priority = NULL;
+    for (int i = 0; i < 2; i++) {
+        heaps[i] = phCreate(copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    }
+
+    ASSERT_TEST(heaps[0] != NULL && heaps[1] != NULL && expected[0] != NULL && expected[1] != NULL, destroy);
+    ASSERT_TEST(phCreate(copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric, NULL) == NULL, destroy);
+    ASSERT_TEST(phPop(heaps[0], NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+    ASSERT_TEST(phMeld(heaps[0], heaps[0]) == PQ_ERROR && phMeld(NULL, heaps[0]) == PQ_NULL_ARGUMENT, destroy);
+
+    // every element is unique (its id), so its handle can be found again to change its priority
+    for (int id = 0; id < 2000; id++) {
+        int side = id % 2;
+        int operation = rand() % 10;
+        int new_priority = rand() % 50;
+        if (operation < 6 || phGetSize(heaps[side]) == 0) {
+            priorities[id] = rand() % 50;
+            ASSERT_TEST(phInsert(heaps[side], &id, &priorities[id], &nodes[id]) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(pqInsert(expected[side], &id, &priorities[id]) == PQ_SUCCESS, destroy);
+            alive[id] = true;
+        } else if (operation < 8) {
+            ASSERT_TEST(phPop(heaps[side], (PQElement *) &element, (PQElementPriority *) &priority) == PQ_SUCCESS,
+                        destroy);
+            ASSERT_TEST(*element == *(int *) pqGetFirst(expected[side]), destroy);
+            ASSERT_TEST(*priority == priorities[*element], destroy);
+            alive[*element] = false;
+            pqRemove(expected[side]);
+            free(element);
+            free(priority);
+            element = NULL;
+            priority = NULL;
+        } else {
+            // an earlier element of the same heap that is still in it
+            int changed = id - 2;
+            while (changed >= 0 && !alive[changed]) {
+                changed -= 2;
+            }
+            if (changed >= 0) {
+                ASSERT_TEST(phChangePriority(heaps[side], nodes[changed], &new_priority) == PQ_SUCCESS, destroy);
+                ASSERT_TEST(pqChangePriority(expected[side], &changed, &priorities[changed], &new_priority) ==
+                            PQ_SUCCESS, destroy);
+                priorities[changed] = new_priority;
+            }
+        }
+
+        PQElement top;
+        ASSERT_TEST(phGetSize(heaps[side]) == pqGetSize(expected[side]), destroy);
+        ASSERT_TEST(phGetSize(heaps[side]) == 0 ||
+                    (phPeek(heaps[side], &top, NULL) == PQ_SUCCESS &&
+                     *(int *) top == *(int *) pqGetFirst(expected[side])), destroy);
+    }
+
+    // after a meld, the handles of both heaps still work, and the priorities come out in order
+    int size = phGetSize(heaps[0]) + phGetSize(heaps[1]);
+    ASSERT_TEST(phMeld(heaps[0], heaps[1]) == PQ_SUCCESS && pqMeld(expected[0], expected[1]) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(phGetSize(heaps[0]) == size && phGetSize(heaps[1]) == 0, destroy);
+    for (int id = 0; id < 2000; id += 7) {
+        if (alive[id]) {
+            int new_priority = rand() % 50;
+            ASSERT_TEST(phChangePriority(heaps[0], nodes[id], &new_priority) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(pqChangePriority(expected[0], &id, &priorities[id], &new_priority) == PQ_SUCCESS, destroy);
+            priorities[id] = new_priority;
+        }
+    }
+    for (int i = 0; i < size; i++) {
+        PQElementPriority expected_priority;
+        pqPeek(expected[0], NULL, &expected_priority);
+        ASSERT_TEST(phPop(heaps[0], (PQElement *) &element, (PQElementPriority *) &priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*priority == *(int *) expected_priority && alive[*element], destroy);
+        alive[*element] = false;
+        pqRemove(expected[0]);
+        free(element);
+        free(priority);
+        element = NULL;
+        priority = NULL;
+    }
+    ASSERT_TEST(phGetSize(heaps[0]) == 0, destroy);
+
+    destroy:
+    free(element);
+    free(priority);
+    for (int i = 0; i < 2; i++) {
+        phDestroy(heaps[i]);
+        pqDestroy(expected[i]);
+    }
+    return result;
+}
+
+/* ============= TESTING pqCreateBounded ============= */
+bool testPQBoundedRejectsOrEvictsLowestPriority() {
+    bool result = true;
+    PQ reject_pq = pqCreateBounded(3, PQ_BOUND_REJECT, copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                   copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    PQ evict_pq = pqCreateBounded(50, PQ_BOUND_EVICT_MIN, copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                  copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    int *evicted = NULL;
+    int *evicted_priority = NULL;
+    int values[3] = {7, 8, 9};
+    PQElement value_pointers[3] = {&values[0], &values[1], &values[2]};
+
+    ASSERT_TEST(pqCreateBounded(0, PQ_BOUND_REJECT, copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                copyIntGeneric, freeIntGeneric, compareIntsGeneric) == NULL, destroy);
+    ASSERT_TEST(reject_pq != NULL && evict_pq != NULL, destroy);
+
+    // a rejecting queue keeps the elements it already has
+    for (int i = 0; i < 3; i++) {
+        ASSERT_TEST(pqInsert(reject_pq, &i, &i) == PQ_SUCCESS, destroy);
+    }
+    int high = 100;
+    ASSERT_TEST(pqInsert(reject_pq, &high, &high) == PQ_QUEUE_FULL && pqGetSize(reject_pq) == 3, destroy);
+    ASSERT_TEST(pqInsertBatch(reject_pq, value_pointers, value_pointers, 1) == PQ_QUEUE_FULL, destroy);
+    ASSERT_TEST(pqReserve(reject_pq, 100) == PQ_SUCCESS && pqGetCapacity(reject_pq) == 3, destroy);
+    pqRemove(reject_pq);
+    ASSERT_TEST(pqInsertBatch(reject_pq, value_pointers, value_pointers, 2) == PQ_QUEUE_FULL, destroy);
+    ASSERT_TEST(pqInsert(reject_pq, &high, &high) == PQ_SUCCESS && *(int *) pqGetFirst(reject_pq) == 100, destroy);
+
+    // an evicting queue keeps the 50 highest priorities, and hands the evicted ones back
+    for (int i = 0; i < 50; i++) {
+        int priority = 1000 + (i * 919) % 1000;
+        ASSERT_TEST(pqInsert(evict_pq, &i, &priority) == PQ_SUCCESS, destroy);
+    }
+    int low = 5;
+    ASSERT_TEST(pqInsertEvict(evict_pq, &low, &low, (PQElement *) &evicted, NULL) == PQ_QUEUE_FULL, destroy);
+    ASSERT_TEST(evicted == NULL, destroy);
+    for (int i = 50; i < 1000; i++) {
+        int priority = 1000 + (i * 919) % 1000;
+        PriorityQueueResult insert_result = pqInsertEvict(evict_pq, &i, &priority, (PQElement *) &evicted,
+                                                          (PQElementPriority *) &evicted_priority);
+        ASSERT_TEST(insert_result == PQ_SUCCESS || insert_result == PQ_QUEUE_FULL, destroy);
+        ASSERT_TEST(pqGetSize(evict_pq) == 50 && pqGetCapacity(evict_pq) == 50, destroy);
+        if (insert_result == PQ_SUCCESS) {
+            PQElementPriority min_priority;
+            ASSERT_TEST(evicted != NULL && pqPeekMin(evict_pq, NULL, &min_priority) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(*evicted_priority <= *(int *) min_priority, destroy);
+            free(evicted);
+            free(evicted_priority);
+            evicted = NULL;
+            evicted_priority = NULL;
+        }
+    }
+
+    // what is left are the highest priorities: 1999 down to 1950
+    for (int priority = 1999; priority >= 1950; priority--) {
+        PQElementPriority first_priority;
+        ASSERT_TEST(pqPeek(evict_pq, NULL, &first_priority) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(*(int *) first_priority == priority, destroy);
+        pqRemove(evict_pq);
+    }
+
+    destroy:
+    free(evicted);
+    free(evicted_priority);
+    pqDestroy(reject_pq);
+    pqDestroy(evict_pq);
+    return result;
+}
+
+/* ============= TESTING pqSnapshot ============= */
+bool testPQSnapshotSharesUntilChanged() {
+    bool result = true;
+    PQ pq = createHashedPQ();
+    PQ snapshot = NULL;
+    PQ second_snapshot = NULL;
+    PQ copy = NULL;
+
+    ASSERT_TEST(pqSnapshot(NULL) == NULL, destroy);
+    for (int i = 0; i < 30; i++) {
+        int value = i % 10;
+        pqInsert(pq, &value, &i);
+    }
+
+    snapshot = pqSnapshot(pq);
+    second_snapshot = pqSnapshot(pq);
+    ASSERT_TEST(snapshot != NULL && second_snapshot != NULL, destroy);
+    ASSERT_TEST(pqGetSize(snapshot) == 30, destroy);
+    ASSERT_TEST(pqGetFirst(snapshot) == pqGetFirst(pq), destroy); // nothing was copied yet
+
+    // changing the snapshot leaves the other queues as they were
+    int value = 9;
+    ASSERT_TEST(pqRemoveElement(snapshot, &value) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqRemove(snapshot) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqGetSize(snapshot) == 28 && pqGetSize(pq) == 30, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(pq) == 9 && *(int *) pqGetFirst(second_snapshot) == 9, destroy);
+    ASSERT_TEST(*(int *) pqGetFirst(snapshot) == 7, destroy);
+
+    // changing the original leaves the remaining snapshot as it was
+    ASSERT_TEST(pqClear(pq) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqContains(second_snapshot, &value) && pqGetSize(second_snapshot) == 30, destroy);
+
+    // a copy of a snapshot is a full copy, in the same order
+    copy = pqCopy(second_snapshot);
+    ASSERT_TEST(copy != NULL, destroy);
+    pqDestroy(second_snapshot);
+    second_snapshot = NULL;
+    while (pqGetSize(copy) > 0) {
+        int expected = *(int *) pqGetFirst(copy);
+        ASSERT_TEST(pqRemove(copy) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqContains(copy, &expected) == (pqGetSize(copy) >= 10), destroy);
+    }
+
+    destroy:
+    pqDestroy(copy);
+    pqDestroy(second_snapshot);
+    pqDestroy(snapshot);
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQClearOfSnapshotCopiesNothing() {
+    bool result = true;
+    PQOptions options = {0};
+    options.hash_element = hashIntGeneric;
+    PQ pq = pqCreateWithOptions(copyCountedInt, freeIntGeneric, equalIntsGeneric, copyCountedInt, freeIntGeneric,
+                                compareIntsGeneric, &options);
+    PQ snapshot = NULL;
+
+    ASSERT_TEST(pq != NULL, destroy);
+    for (int i = 0; i < 30; i++) {
+        int value = i % 10;
+        ASSERT_TEST(pqInsert(pq, &value, &i) == PQ_SUCCESS, destroy);
+    }
+    snapshot = pqSnapshot(pq);
+    ASSERT_TEST(snapshot != NULL, destroy);
+
+    // clearing either queue leaves the shared elements to the other one, without copying them
+    counted_copies = 0;
+    ASSERT_TEST(pqClear(snapshot) == PQ_SUCCESS && pqGetSize(snapshot) == 0, destroy);
+    ASSERT_TEST(counted_copies == 0 && pqGetSize(pq) == 30, destroy);
+    pqDestroy(snapshot);
+    snapshot = pqSnapshot(pq);
+    ASSERT_TEST(snapshot != NULL, destroy);
+    ASSERT_TEST(pqClear(pq) == PQ_SUCCESS && pqGetSize(pq) == 0, destroy);
+    ASSERT_TEST(counted_copies == 0 && pqGetSize(snapshot) == 30, destroy);
+    int value = 9;
+    ASSERT_TEST(pqContains(snapshot, &value) && !pqContains(pq, &value), destroy);
+
+    // the cleared queue has storage of its own
+    for (int i = 0; i < 30; i++) {
+        ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqContains(pq, &value) && *(int *) pqGetFirst(pq) == 29, destroy);
+    ASSERT_TEST(pqGetSize(snapshot) == 30 && *(int *) pqGetFirst(snapshot) == 9, destroy);
+
+    destroy:
+    pqDestroy(snapshot);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqSetFreeBatch ============= */
+static int freed_in_batches = 0;
+
+static void freeIntsBatch(PQElement *elements, int count) {
+    for (int i = 0; i < count; i++) {
+        free(elements[i]);
+    }
+    freed_in_batches += count;
+}
+
+bool testPQClearAndDestroyUseFreeBatch() {
+    bool result = true;
+    PQ pq = getMultipleElementPQ();
+    PQ snapshot = NULL;
+    freed_in_batches = 0;
+
+    ASSERT_TEST(pqSetFreeBatch(NULL, freeIntsBatch, freeIntsBatch) == PQ_NULL_ARGUMENT, destroy);
+    ASSERT_TEST(pqSetFreeBatch(pq, freeIntsBatch, NULL) == PQ_SUCCESS, destroy);
+
+    int size = pqGetSize(pq);
+    ASSERT_TEST(pqClear(pq) == PQ_SUCCESS && pqGetSize(pq) == 0, destroy);
+    ASSERT_TEST(freed_in_batches == size, destroy);
+    ASSERT_TEST(pqGetFirst(pq) == NULL, destroy);
+
+    // the queue is still usable after the sweep
+    for (int i = 0; i < 25; i++) {
+        int value = i % 5;
+        ASSERT_TEST(pqInsert(pq, &value, &value) == PQ_SUCCESS, destroy);
+    }
+    int value = 4;
+    ASSERT_TEST(pqContains(pq, &value) && *(int *) pqGetFirst(pq) == 4, destroy);
+
+    // the snapshot's destruction leaves the shared elements to pq
+    snapshot = pqSnapshot(pq);
+    pqDestroy(snapshot);
+    snapshot = NULL;
+    ASSERT_TEST(freed_in_batches == size, destroy);
+
+    pqSetFreeBatch(pq, freeIntsBatch, freeIntsBatch);
+    pqDestroy(pq);
+    pq = NULL;
+    ASSERT_TEST(freed_in_batches == size + 50, destroy);
+
+    destroy:
+    pqDestroy(snapshot);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqReserve, pqShrinkToFit and PQOptions ============= */
+bool testPQCapacityReserveAndShrink() {
+    bool result = true;
+    PQOptions options = {0};
+    options.initial_capacity = 4;
+    options.growth_factor = 1.5;
+    options.shrink_threshold = 0.25;
+    options.hash_element = hashIntGeneric;
+    PQ pq = pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric, freeIntGeneric,
+                                compareIntsGeneric, &options);
+    PQ inline_pq = pqCreateInline(sizeof(int), sizeof(int), equalIntsGeneric, compareIntsGeneric);
+
+    PQOptions invalid_options = {0};
+    invalid_options.shrink_threshold = 0.5; // 0.5 * 2 would grow back right after shrinking
+    ASSERT_TEST(pqCreateWithOptions(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                    freeIntGeneric, compareIntsGeneric, &invalid_options) == NULL, destroy);
+    ASSERT_TEST(pq != NULL && inline_pq != NULL && pqGetCapacity(pq) == 4, destroy);
+    ASSERT_TEST(pqReserve(NULL, 5) == PQ_NULL_ARGUMENT && pqReserve(pq, -1) == PQ_ERROR, destroy);
+
+    ASSERT_TEST(pqReserve(pq, 1000) == PQ_SUCCESS && pqGetCapacity(pq) == 1000, destroy);
+    for (int i = 0; i < 1000; i++) {
+        int value = i % 100;
+        ASSERT_TEST(pqInsert(pq, &value, &i) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsert(inline_pq, &value, &i) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(pqGetCapacity(pq) == 1000, destroy); // no expansion was needed
+
+    // removing most elements makes the queue shrink, moving the remaining ones into the kept part
+    for (int i = 999; i >= 100; i--) {
+        ASSERT_TEST(pqRemove(pq) == PQ_SUCCESS, destroy);
+        if (i % 2 == 0) {
+            int value = i % 100;
+            ASSERT_TEST(pqRemoveElement(inline_pq, &value) == PQ_SUCCESS, destroy);
+        } else {
+            ASSERT_TEST(pqPopInto(inline_pq, NULL, NULL) == PQ_SUCCESS, destroy);
+        }
+    }
+    ASSERT_TEST(pqGetSize(pq) == 100 && pqGetCapacity(pq) < 1000 && pqGetCapacity(pq) >= 100, destroy);
+    int value = 42;
+    ASSERT_TEST(pqContains(pq, &value), destroy);
+    ASSERT_TEST(pqRemoveElement(pq, &value) == PQ_SUCCESS && !pqContains(pq, &value), destroy);
+
+    ASSERT_TEST(pqShrinkToFit(inline_pq) == PQ_SUCCESS && pqGetCapacity(inline_pq) == 100, destroy);
+    ASSERT_TEST(pqShrinkToFit(pq) == PQ_SUCCESS && pqGetCapacity(pq) == 99, destroy);
+
+    // the remaining elements still come out in order
+    int expected = 99;
+    while (pqGetSize(pq) > 0) {
+        if (expected == 42) {
+            expected--;
+        }
+        ASSERT_TEST(*(int *) pqGetFirst(pq) == expected--, destroy);
+        pqRemove(pq);
+    }
+    ASSERT_TEST(pqGetCapacity(pq) == 4, destroy); // never below the initial capacity
+    int element = -1;
+    ASSERT_TEST(pqPopInto(inline_pq, &element, NULL) == PQ_SUCCESS && element == 99, destroy);
+    ASSERT_TEST(pqGetCapacity(inline_pq) == 100, destroy); // the default options never shrink
+
+    destroy:
+    pqDestroy(inline_pq);
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING pqCreateWithAllocator and PQPool ============= */
+static int allocator_live_blocks = 0;
+static PQPool int_pool = NULL;
+
+static void *countingAlloc(void *context, size_t size) {
+    (*(int *) context)++;
+    return malloc(size);
+}
+
+static void *countingRealloc(void *context, void *pointer, size_t size) {
+    (void) context;
+    return realloc(pointer, size);
+}
+
+static void countingFree(void *context, void *pointer) {
+    (*(int *) context)--;
+    free(pointer);
+}
+
+static PQElement copyIntPooled(PQElement n) {
+    int *copy = pqPoolAlloc(int_pool);
+    if (copy != NULL) {
+        *copy = *(int *) n;
+    }
+    return copy;
+}
+
+static void freeIntPooled(PQElement n) {
+    pqPoolFree(int_pool, n);
+}
+
+bool testPQAllocatorAndPoolAreUsedForAllMemory() {
+    bool result = true;
+    PQAllocator allocator = {countingAlloc, countingRealloc, countingFree, &allocator_live_blocks};
+    allocator_live_blocks = 0;
+    int_pool = pqPoolCreate(sizeof(int), 64, &allocator);
+    PQ pq = pqCreateWithAllocator(copyIntPooled, freeIntPooled, equalIntsGeneric, copyIntPooled, freeIntPooled,
+                                  compareIntsGeneric, &allocator);
+    PQ copy = NULL;
+    PQIterator iterator = NULL;
+
+    ASSERT_TEST(pqCreateWithAllocator(copyIntGeneric, freeIntGeneric, equalIntsGeneric, copyIntGeneric,
+                                      freeIntGeneric, compareIntsGeneric, NULL) == NULL, destroy);
+    ASSERT_TEST(pqPoolCreate(0, 64, NULL) == NULL && pqPoolAlloc(NULL) == NULL, destroy);
+    ASSERT_TEST(int_pool != NULL && pq != NULL, destroy);
+
+    for (int i = 0; i < 200; i++) {
+        ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+    }
+    copy = pqCopy(pq);
+    iterator = pqIterBegin(copy);
+    ASSERT_TEST(copy != NULL && iterator != NULL, destroy);
+    ASSERT_TEST(*(int *) pqIterNext(iterator) == 199, destroy);
+
+    // every object that was freed is reused before a new slab is allocated
+    int live_blocks = allocator_live_blocks;
+    for (int i = 0; i < 100; i++) {
+        pqRemove(pq);
+        ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+    }
+    ASSERT_TEST(allocator_live_blocks == live_blocks, destroy);
+
+    destroy:
+    pqDestroy(copy);
+    pqIterEnd(iterator); // may be ended after its queue was destroyed
+    pqDestroy(pq);
+    pqPoolDestroy(int_pool);
+    int_pool = NULL;
+    if (result) {
+        ASSERT_TEST(allocator_live_blocks == 0, end); // everything was freed with the allocator
+    }
+    end:
+    return result;
+}
+
+/* ============= TESTING ConcurrentPriorityQueue ============= */
+#define CONCURRENT_THREADS 4
+#define CONCURRENT_ELEMENTS_PER_THREAD 2000
+
+typedef struct {
+    ConcurrentPriorityQueue queue;
+    int first_element;
+    int popped[CONCURRENT_ELEMENTS_PER_THREAD];
+    int popped_count;
+} ConcurrentTestArgs;
+
+// inserts the thread's elements, popping one element after every other insertion
+static void *insertAndPopConcurrently(void *arguments) {
+    ConcurrentTestArgs *args = arguments;
+    args->popped_count = 0;
+    for (int i = 0; i < CONCURRENT_ELEMENTS_PER_THREAD; i++) {
+        int element = args->first_element + i;
+        cpqInsert(args->queue, &element, &element);
+        int *popped = NULL;
+        if (i % 2 == 1 && cpqPop(args->queue, (PQElement *) &popped, NULL) == PQ_SUCCESS) {
+            args->popped[args->popped_count++] = *popped;
+            free(popped);
+        }
+    }
+    return NULL;
+}
+
+bool testConcurrentPQInsertAndPopFromManyThreads() {
+    bool result = true;
+    ConcurrentPriorityQueue queue = cpqCreate(copyIntGeneric, freeIntGeneric, copyIntGeneric, freeIntGeneric,
+                                              compareIntsGeneric);
+    pthread_t threads[CONCURRENT_THREADS];
+    ConcurrentTestArgs args[CONCURRENT_THREADS];
+    const int total = CONCURRENT_THREADS * CONCURRENT_ELEMENTS_PER_THREAD;
+    bool *seen = calloc(total, sizeof(bool));
+
+    ASSERT_TEST(cpqCreate(NULL, freeIntGeneric, copyIntGeneric, freeIntGeneric, compareIntsGeneric) == NULL,
+                destroy);
+    ASSERT_TEST(queue != NULL && seen != NULL, destroy);
+    ASSERT_TEST(cpqPop(queue, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+
+    for (int thread = 0; thread < CONCURRENT_THREADS; thread++) {
+        args[thread].queue = queue;
+        args[thread].first_element = thread * CONCURRENT_ELEMENTS_PER_THREAD;
+        pthread_create(&threads[thread], NULL, insertAndPopConcurrently, &args[thread]);
+    }
+    int popped_total = 0;
+    for (int thread = 0; thread < CONCURRENT_THREADS; thread++) {
+        pthread_join(threads[thread], NULL);
+        for (int i = 0; i < args[thread].popped_count; i++) {
+            ASSERT_TEST(!seen[args[thread].popped[i]], destroy);
+            seen[args[thread].popped[i]] = true;
+        }
+        popped_total += args[thread].popped_count;
+    }
+    ASSERT_TEST(popped_total == total / 2 && cpqGetSize(queue) == total - popped_total, destroy);
+
+    // once the threads are done, the rest of the elements come out in order, each exactly once
+    int previous = total;
+    int *element = NULL;
+    while (cpqPop(queue, (PQElement *) &element, NULL) == PQ_SUCCESS) {
+        ASSERT_TEST(*element < previous && !seen[*element], destroy);
+        previous = *element;
+        seen[*element] = true;
+        free(element);
+        element = NULL;
+    }
+    for (int i = 0; i < total; i++) {
+        ASSERT_TEST(seen[i], destroy);
+    }
+
+    destroy:
+    free(element);
+    free(seen);
+    cpqDestroy(queue);
+    return result;
+}
+
+#define MULTI_QUEUE_SHARDS (2 * CONCURRENT_THREADS)
+
+typedef struct {
+    MultiQueue queue;
+    int first_element;
+    int popped[CONCURRENT_ELEMENTS_PER_THREAD];
+    int popped_count;
+} MultiQueueTestArgs;
+
+// inserts the thread's elements, popping one element after every other insertion
+static void *insertAndPopMultiQueue(void *arguments) {
+    MultiQueueTestArgs *args = arguments;
+    args->popped_count = 0;
+    for (int i = 0; i < CONCURRENT_ELEMENTS_PER_THREAD; i++) {
+        int element = args->first_element + i;
+        mqInsert(args->queue, &element, &element);
+        int *popped = NULL;
+        if (i % 2 == 1 && mqPop(args->queue, (PQElement *) &popped, NULL) == PQ_SUCCESS) {
+            args->popped[args->popped_count++] = *popped;
+            free(popped);
+        }
+    }
+    return NULL;
+}
+
+bool testMultiQueuePopsEveryElementOnceAndMeasuresRankError() {
+    bool result = true;
+    MultiQueue queue = mqCreate(MULTI_QUEUE_SHARDS, copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    MultiQueue exact_queue = mqCreate(1, copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                                      copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    pthread_t threads[CONCURRENT_THREADS];
+    MultiQueueTestArgs args[CONCURRENT_THREADS];
+    const int total = CONCURRENT_THREADS * CONCURRENT_ELEMENTS_PER_THREAD;
+    bool *seen = calloc(total, sizeof(bool));
+    MQRankStatistics statistics;
+
+    ASSERT_TEST(mqCreate(0, copyIntGeneric, freeIntGeneric, equalIntsGeneric,
+                         copyIntGeneric, freeIntGeneric, compareIntsGeneric) == NULL, destroy);
+    ASSERT_TEST(queue != NULL && exact_queue != NULL && seen != NULL, destroy);
+    ASSERT_TEST(mqPop(queue, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+
+    for (int thread = 0; thread < CONCURRENT_THREADS; thread++) {
+        args[thread].queue = queue;
+        args[thread].first_element = thread * CONCURRENT_ELEMENTS_PER_THREAD;
+        pthread_create(&threads[thread], NULL, insertAndPopMultiQueue, &args[thread]);
+    }
+    int popped_total = 0;
+    for (int thread = 0; thread < CONCURRENT_THREADS; thread++) {
+        pthread_join(threads[thread], NULL);
+        for (int i = 0; i < args[thread].popped_count; i++) {
+            ASSERT_TEST(!seen[args[thread].popped[i]], destroy);
+            seen[args[thread].popped[i]] = true;
+        }
+        popped_total += args[thread].popped_count;
+    }
+    ASSERT_TEST(popped_total == total / 2 && mqGetSize(queue) == total - popped_total, destroy);
+
+    // the rest of the elements come out each exactly once, and the rank error of every pop is measured
+    ASSERT_TEST(mqSetRankTracking(queue, true) == PQ_SUCCESS, destroy);
+    int *element = NULL;
+    while (mqPop(queue, (PQElement *) &element, NULL) == PQ_SUCCESS) {
+        ASSERT_TEST(!seen[*element], destroy);
+        seen[*element] = true;
+        free(element);
+        element = NULL;
+    }
+    for (int i = 0; i < total; i++) {
+        ASSERT_TEST(seen[i], destroy);
+    }
+    ASSERT_TEST(mqGetRankStatistics(queue, &statistics) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(statistics.pops == total - popped_total && statistics.mean_rank_error >= 0 &&
+                statistics.max_rank_error >= statistics.mean_rank_error, destroy);
+
+    // with one shard, every pop returns the highest priority
+    ASSERT_TEST(mqSetRankTracking(exact_queue, true) == PQ_SUCCESS, destroy);
+    for (int i = 0; i < 100; i++) {
+        int value = (i * 37) % 100;
+        ASSERT_TEST(mqInsert(exact_queue, &value, &value) == PQ_SUCCESS, destroy);
+    }
+    for (int i = 99; i >= 0; i--) {
+        ASSERT_TEST(mqPop(exact_queue, (PQElement *) &element, NULL) == PQ_SUCCESS && *element == i, destroy);
+        free(element);
+        element = NULL;
+    }
+    ASSERT_TEST(mqGetRankStatistics(exact_queue, &statistics) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(statistics.pops == 100 && statistics.max_rank_error == 0, destroy);
+
+    destroy:
+    free(element);
+    free(seen);
+    mqDestroy(queue);
+    mqDestroy(exact_queue);
+    return result;
+}
+
+/* ============= TESTING RadixHeap ============= */
+bool testRadixHeapPopsMonotoneKeysInOrder() {
+    bool result = true;
+    RadixHeap heap = rhCreate(copyIntGeneric, freeIntGeneric);
+    int *element = NULL;
+    unsigned long long key = 0;
+    unsigned long long last_key = 0;
+    unsigned long long peeked_key = 0;
+
+    ASSERT_TEST(rhCreate(NULL, freeIntGeneric) == NULL, destroy);
+    ASSERT_TEST(heap != NULL && rhGetSize(heap) == 0, destroy);
+    ASSERT_TEST(rhPop(heap, NULL, NULL) == PQ_ITEM_DOES_NOT_EXIST, destroy);
+
+    // equal keys come out by insertion order
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TEST(rhInsert(heap, &i, 42) == PQ_SUCCESS, destroy);
+    }
+    for (int i = 0; i < 5; i++) {
+        ASSERT_TEST(rhPop(heap, (PQElement *) &element, &key) == PQ_SUCCESS && *element == i && key == 42, destroy);
+        free(element);
+        element = NULL;
+    }
+    ASSERT_TEST(rhInsert(heap, &key, 41) == PQ_ERROR, destroy);
+
+    // peeking doesn't pop anything, so a key between the last popped key and the peeked one still fits
+    ASSERT_TEST(rhInsert(heap, &key, 100) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(rhPeek(heap, NULL, &peeked_key) == PQ_SUCCESS && peeked_key == 100, destroy);
+    ASSERT_TEST(rhInsert(heap, &key, 50) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(rhPop(heap, NULL, &key) == PQ_SUCCESS && key == 50, destroy);
+    ASSERT_TEST(rhPop(heap, NULL, &key) == PQ_SUCCESS && key == 100, destroy);
+    ASSERT_TEST(rhInsert(heap, &key, 99) == PQ_ERROR, destroy);
+    last_key = 100;
+
+    // a shortest-path like workload: every insertion is above the last popped key, spread over all bits
+    for (int step = 0; step < 5000; step++) {
+        if (rhGetSize(heap) == 0 || rand() % 3 != 0) {
+            unsigned long long offset = (unsigned long long) rand() << (rand() % 33);
+            ASSERT_TEST(rhInsert(heap, &step, last_key + offset) == PQ_SUCCESS, destroy);
+        } else {
+            ASSERT_TEST(rhPeek(heap, NULL, &peeked_key) == PQ_SUCCESS, destroy);
+            ASSERT_TEST(rhPop(heap, NULL, &key) == PQ_SUCCESS && key == peeked_key && key >= last_key, destroy);
+            last_key = key;
+        }
+    }
+    ASSERT_TEST(rhInsert(heap, &key, ~0ULL) == PQ_SUCCESS, destroy);
+    while (rhPop(heap, NULL, &key) == PQ_SUCCESS) {
+        ASSERT_TEST(key >= last_key, destroy);
+        last_key = key;
+    }
+    ASSERT_TEST(last_key == ~0ULL && rhGetSize(heap) == 0, destroy);
+
+    ASSERT_TEST(rhInsert(heap, &key, ~0ULL) == PQ_SUCCESS && rhClear(heap) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(rhGetSize(heap) == 0, destroy);
+
+    destroy:
+    free(element);
+    rhDestroy(heap);
+    return result;
+}
+
+/* ============= TESTING TimingWheel ============= */
+typedef struct {
+    unsigned long long last_deadline;
+    int expired;
+    bool in_order;
+} ExpiryLog;
+
+static void logExpiry(PQElement element, unsigned long long deadline, void *context) {
+    ExpiryLog *log = context;
+    if (deadline < log->last_deadline || *(unsigned long long *) element != deadline) {
+        log->in_order = false;
+    }
+    log->last_deadline = deadline;
+    log->expired++;
+}
+
+static PQElement copyDeadline(PQElement deadline) {
+    unsigned long long *copy = malloc(sizeof(*copy));
+    if (copy != NULL) {
+        *copy = *(unsigned long long *) deadline;
+    }
+    return copy;
+}
+
+bool testTimingWheelExpiresInOrderAndCancels() {
+    bool result = true;
+    TimingWheel wheel = twCreate(copyDeadline, freeIntGeneric, 1000);
+    TWTimer timers[2000];
+    ExpiryLog log = {0, 0, true};
+    unsigned long long *cancelled = NULL;
+
+    ASSERT_TEST(twCreate(NULL, freeIntGeneric, 0) == NULL, destroy);
+    ASSERT_TEST(wheel != NULL && twGetTime(wheel) == 1000, destroy);
+    ASSERT_TEST(twAdvance(wheel, 999, logExpiry, &log) == -1, destroy);
+
+    // deadlines spread over many wheels, most of them cancelled before they expire
+    for (int i = 0; i < 2000; i++) {
+        unsigned long long deadline = 1000 + ((unsigned long long) rand() << (rand() % 20));
+        ASSERT_TEST(twInsert(wheel, &deadline, deadline, &timers[i]) == PQ_SUCCESS, destroy);
+    }
+    int cancelled_count = 0;
+    for (int i = 0; i < 2000; i += 3) {
+        ASSERT_TEST(twCancel(wheel, timers[i], (PQElement *) &cancelled) == PQ_SUCCESS, destroy);
+        free(cancelled);
+        cancelled = NULL;
+        cancelled_count++;
+    }
+    ASSERT_TEST(twGetSize(wheel) == 2000 - cancelled_count, destroy);
+
+    // advancing in uneven steps expires everything in deadline order, each timer once
+    unsigned long long now = 1000;
+    while (twGetSize(wheel) > 0) {
+        now += (unsigned long long) rand() << (rand() % 16);
+        int expired_before = log.expired;
+        int expired = twAdvance(wheel, now, logExpiry, &log);
+        ASSERT_TEST(expired == log.expired - expired_before && log.in_order && log.last_deadline <= now, destroy);
+    }
+    ASSERT_TEST(log.expired == 2000 - cancelled_count && twGetTime(wheel) == now, destroy);
+
+    // a deadline that was already reached expires on the next advance
+    unsigned long long past = 5;
+    ASSERT_TEST(twInsert(wheel, &past, past, NULL) == PQ_SUCCESS, destroy);
+    log.last_deadline = 0;
+    ASSERT_TEST(twAdvance(wheel, now, logExpiry, &log) == 1 && twGetSize(wheel) == 0, destroy);
+
+    destroy:
+    free(cancelled);
+    twDestroy(wheel);
+    return result;
+}
+
 /* ============= TESTING pqRemoveElement ============= */
 
 bool testPQRemoveElementStandardTestAndAlsoOnlyRemovesFirstOfMultipleSameElements() {
@@ -694,6 +2299,121 @@ bool testPQIteratorPointsToNullAfterSomeOfTheFunctions() {
 }
 
 
+bool testPQIteratorTraversesLargeQueueInOrderWithoutChangingIt() {
+    bool result = true;
+    PQ pq = createPQ();
+
+    int count = 1000;
+    for (int i = 0; i < count; i++) {
+        int prio = rand() % 100;
+        pqInsert(pq, &i, &prio);
+    }
+
+    // the same traversal twice: iterating doesn't change the queue
+    for (int pass = 0; pass < 2; pass++) {
+        int visited = 0;
+        PQ_FOREACH(int *, elem, pq) {
+            visited++;
+        }
+        ASSERT_TEST(visited == count, destroy);
+    }
+    ASSERT_TEST(pqGetSize(pq) == count, destroy);
+
+    // the iterator returns the elements in the same order that pqRemove removes them
+    PQ copy = pqCopy(pq);
+    ASSERT_TEST(copy != NULL, destroy);
+    int *expected = pqGetFirst(pq);
+    for (int i = 0; i < count; i++) {
+        int *removed = pqGetFirst(copy);
+        ASSERT_TEST(expected != NULL && *expected == *removed, destroyCopy);
+        pqRemove(copy);
+        expected = pqGetNext(pq);
+    }
+    ASSERT_TEST(expected == NULL, destroyCopy);
+
+    destroyCopy:
+    pqDestroy(copy);
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+/* ============= TESTING PQIterator ============= */
+bool testPQIterNullArgument() {
+    bool result = true;
+    ASSERT_TEST(pqIterBegin(NULL) == NULL, destroy);
+    ASSERT_TEST(pqIterNext(NULL) == NULL, destroy);
+    pqIterEnd(NULL);
+
+    destroy:
+    return result;
+}
+
+bool testPQIterIndependentIterators() {
+    bool result = true;
+    PQ pq = createPQ();
+    PQIterator outer = NULL;
+    PQIterator inner = NULL;
+
+    int count = 10;
+    for (int i = 0; i < count; i++) {
+        pqInsert(pq, &i, &i);
+    }
+
+    ASSERT_TEST((*(int *) pqGetFirst(pq)) == count - 1, destroy);
+
+    // every pair of elements, with two iterators at once
+    outer = pqIterBegin(pq);
+    ASSERT_TEST(outer != NULL, destroy);
+    int expected_outer = count - 1;
+    int pairs = 0;
+    PQ_ITER_FOREACH(int *, first, outer) {
+        ASSERT_TEST(*first == expected_outer, destroy);
+        expected_outer--;
+
+        inner = pqIterBegin(pq);
+        ASSERT_TEST(inner != NULL, destroy);
+        PQ_ITER_FOREACH(int *, second, inner) {
+            pairs++;
+        }
+        pqIterEnd(inner);
+        inner = NULL;
+    }
+    ASSERT_TEST(pairs == count * count, destroy);
+
+    // the internal iterator wasn't touched by the other iterators
+    ASSERT_TEST((*(int *) pqGetNext(pq)) == count - 2, destroy);
+
+    destroy:
+    pqIterEnd(inner);
+    pqIterEnd(outer);
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQIterUndefinedAfterChange() {
+    bool result = true;
+    PQ pq = getMultipleElementPQ();
+    PQIterator iterator = pqIterBegin(pq);
+    PQIterator unstarted = pqIterBegin(pq);
+    ASSERT_TEST(iterator != NULL && unstarted != NULL, destroy);
+
+    ASSERT_TEST(pqIterNext(iterator) != NULL, destroy);
+    pqContains(pq, pqGetFirst(pq));
+    pqGetSize(pq);
+    ASSERT_TEST(pqIterNext(iterator) != NULL, destroy);
+
+    pqInsertRandom(pq);
+    ASSERT_TEST(pqIterNext(iterator) == NULL, destroy);
+    ASSERT_TEST(pqIterNext(unstarted) == NULL, destroy);
+
+    destroy:
+    pqIterEnd(iterator);
+    pqIterEnd(unstarted);
+    pqDestroy(pq);
+    return result;
+}
+
 /* ============= TESTING pqClear ============= */
 bool testPQClearWorksOkayOnEmptyQueue() {
     bool result = true;
@@ -723,6 +2443,90 @@ bool testPQClearStandardTest() {
 
 
 
+/* ============= TESTING pqCreateHashed ============= */
+bool testPQCreateHashedNullArgument() {
+    bool result = true;
+    PQ pq = pqCreateHashed(copyIntGeneric, freeIntGeneric, equalIntsGeneric, NULL,
+                           copyIntGeneric, freeIntGeneric, compareIntsGeneric);
+    ASSERT_TEST(pq == NULL, destroy);
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQHashedContainsAndRemoveElementWithDuplicates() {
+    bool result = true;
+    PQ pq = createHashedPQ();
+
+    // enough distinct elements for the element index to grow, each one inserted twice
+    int count = 200;
+    for (int i = 0; i < count; i++) {
+        int prio = i % 7;
+        ASSERT_TEST(pqInsert(pq, &i, &prio) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqInsert(pq, &i, &i) == PQ_SUCCESS, destroy);
+    }
+    for (int i = 0; i < count; i++) {
+        ASSERT_TEST(pqContains(pq, &i) == true, destroy);
+    }
+
+    // removes the even elements one copy at a time
+    for (int i = 0; i < count; i += 2) {
+        ASSERT_TEST(pqRemoveElement(pq, &i) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqContains(pq, &i) == true, destroy);
+        ASSERT_TEST(pqRemoveElement(pq, &i) == PQ_SUCCESS, destroy);
+        ASSERT_TEST(pqContains(pq, &i) == false, destroy);
+        ASSERT_TEST(pqRemoveElement(pq, &i) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    }
+    ASSERT_TEST(pqGetSize(pq) == count, destroy);
+    for (int i = 1; i < count; i += 2) {
+        ASSERT_TEST(pqContains(pq, &i) == true, destroy);
+    }
+
+    // the odd elements are left, and the copies with priority i (above the i % 7 priorities) come out first
+    for (int i = count - 1; i > 7; i -= 2) {
+        ASSERT_TEST((*(int *) pqGetFirst(pq)) == i, destroy);
+        pqRemove(pq);
+    }
+
+    destroy:
+    pqDestroy(pq);
+    return result;
+}
+
+bool testPQHashedChangePriorityAndCopy() {
+    bool result = true;
+    PQ pq = createHashedPQ();
+    PQ new_pq = NULL;
+
+    int elem = 1;
+    int prio = 1;
+    int mid_elem = 5;
+    int high_prio = 10;
+    pqInsert(pq, &elem, &prio);
+    pqInsert(pq, &elem, &prio);
+    pqInsert(pq, &mid_elem, &mid_elem);
+
+    ASSERT_TEST(pqChangePriority(pq, &elem, &high_prio, &prio) == PQ_ELEMENT_DOES_NOT_EXISTS, destroy);
+    ASSERT_TEST(pqChangePriority(pq, &elem, &prio, &high_prio) == PQ_SUCCESS, destroy);
+
+    new_pq = pqCopy(pq);
+    ASSERT_TEST(new_pq != NULL, destroy);
+    ASSERT_TEST(pqContains(new_pq, &mid_elem) == true, destroy);
+    ASSERT_TEST(pqRemoveElement(new_pq, &mid_elem) == PQ_SUCCESS, destroy);
+    ASSERT_TEST(pqContains(new_pq, &mid_elem) == false, destroy);
+    ASSERT_TEST(pqContains(pq, &mid_elem) == true, destroy);
+
+    ASSERT_TEST((*(int *) pqGetFirst(pq)) == elem, destroy);
+    ASSERT_TEST((*(int *) pqGetNext(pq)) == mid_elem, destroy);
+    ASSERT_TEST((*(int *) pqGetNext(pq)) == elem, destroy);
+
+    destroy:
+    pqDestroy(new_pq);
+    pqDestroy(pq);
+    return result;
+}
+
 /* ============= Course given tests ============= */
 bool testPQCreateDestroy() {
     bool result = true;
@@ -834,7 +2638,38 @@ bool (*tests[])(void) = {
         testPQGetNextStandardTest,
         testPQGetNextTraversesTheQueueCorrectlyByPriority,
         testPQClearStandardTest,
-        testPQClearWorksOkayOnEmptyQueue
+        testPQClearWorksOkayOnEmptyQueue,
+        testPQRemoveKeepsInsertionOrderOfEqualPriorities,
+        testPQChangePriorityRepeatedlyKeepsQueueOrdered,
+        testPQCreateHashedNullArgument,
+        testPQHashedContainsAndRemoveElementWithDuplicates,
+        testPQHashedChangePriorityAndCopy,
+        testPQIteratorTraversesLargeQueueInOrderWithoutChangingIt,
+        testPQIterNullArgument,
+        testPQIterIndependentIterators,
+        testPQIterUndefinedAfterChange,
+        testPQInsertOwnedAndPopOwned,
+        testPQPopReturnsElementsByPriority,
+        testPQInlineStoresValuesAndGrows,
+        testPQDeclareKeepsSameOrderAsGenericQueue,
+        testPQInsertBulkMatchesSeparateInserts,
+        testPQSnapshotSharesUntilChanged,
+        testPQClearAndDestroyUseFreeBatch,
+        testPQCapacityReserveAndShrink,
+        testPQAllocatorAndPoolAreUsedForAllMemory,
+        testConcurrentPQInsertAndPopFromManyThreads,
+        testMultiQueuePopsEveryElementOnceAndMeasuresRankError,
+        testPQBatchesMatchSeparateInsertsAndPops,
+        testPQPeekTopKMatchesPopOrderWithoutChangingQueue,
+        testPQDoubleEndedMatchesRegularQueueAtBothEnds,
+        testPQBoundedRejectsOrEvictsLowestPriority,
+        testRadixHeapPopsMonotoneKeysInOrder,
+        testTimingWheelExpiresInOrderAndCancels,
+        testPQArityQueuesMatchBinaryQueue,
+        testPQPrimitivePrioritiesMatchCustomQueue,
+        testPQMeldMovesElementsWithoutCopying,
+        testPairingHeapMatchesPriorityQueueAndMelds,
+        testPQClearOfSnapshotCopiesNothing
 };
 
 const char *testNames[] = {
@@ -876,7 +2711,38 @@ const char *testNames[] = {
         "testPQGetNextStandardTest",
         "testPQGetNextTraversesTheQueueCorrectlyByPriority",
         "testPQClearStandardTest",
-        "testPQClearWorksOkayOnEmptyQueue"
+        "testPQClearWorksOkayOnEmptyQueue",
+        "testPQRemoveKeepsInsertionOrderOfEqualPriorities",
+        "testPQChangePriorityRepeatedlyKeepsQueueOrdered",
+        "testPQCreateHashedNullArgument",
+        "testPQHashedContainsAndRemoveElementWithDuplicates",
+        "testPQHashedChangePriorityAndCopy",
+        "testPQIteratorTraversesLargeQueueInOrderWithoutChangingIt",
+        "testPQIterNullArgument",
+        "testPQIterIndependentIterators",
+        "testPQIterUndefinedAfterChange",
+        "testPQInsertOwnedAndPopOwned",
+        "testPQPopReturnsElementsByPriority",
+        "testPQInlineStoresValuesAndGrows",
+        "testPQDeclareKeepsSameOrderAsGenericQueue",
+        "testPQInsertBulkMatchesSeparateInserts",
+        "testPQSnapshotSharesUntilChanged",
+        "testPQClearAndDestroyUseFreeBatch",
+        "testPQCapacityReserveAndShrink",
+        "testPQAllocatorAndPoolAreUsedForAllMemory",
+        "testConcurrentPQInsertAndPopFromManyThreads",
+        "testMultiQueuePopsEveryElementOnceAndMeasuresRankError",
+        "testPQBatchesMatchSeparateInsertsAndPops",
+        "testPQPeekTopKMatchesPopOrderWithoutChangingQueue",
+        "testPQDoubleEndedMatchesRegularQueueAtBothEnds",
+        "testPQBoundedRejectsOrEvictsLowestPriority",
+        "testRadixHeapPopsMonotoneKeysInOrder",
+        "testTimingWheelExpiresInOrderAndCancels",
+        "testPQArityQueuesMatchBinaryQueue",
+        "testPQPrimitivePrioritiesMatchCustomQueue",
+        "testPQMeldMovesElementsWithoutCopying",
+        "testPairingHeapMatchesPriorityQueueAndMelds",
+        "testPQClearOfSnapshotCopiesNothing"
 };
 
 const char *testFailDescriptions[] = {
@@ -918,7 +2784,38 @@ const char *testFailDescriptions[] = {
         "Please refer to the testing code at function: testPQGetNextStandardTest",
         "Please refer to the testing code at function: testPQGetNextTraversesTheQueueCorrectlyByPriority",
         "Please refer to the testing code at function: testPQClearStandardTest",
-        "Please refer to the testing code at function: testPQClearWorksOkayOnEmptyQueue"
+        "Please refer to the testing code at function: testPQClearWorksOkayOnEmptyQueue",
+        "Please refer to the testing code at function: testPQRemoveKeepsInsertionOrderOfEqualPriorities",
+        "Please refer to the testing code at function: testPQChangePriorityRepeatedlyKeepsQueueOrdered",
+        "Please refer to the testing code at function: testPQCreateHashedNullArgument",
+        "Please refer to the testing code at function: testPQHashedContainsAndRemoveElementWithDuplicates",
+        "Please refer to the testing code at function: testPQHashedChangePriorityAndCopy",
+        "Please refer to the testing code at function: testPQIteratorTraversesLargeQueueInOrderWithoutChangingIt",
+        "Please refer to the testing code at function: testPQIterNullArgument",
+        "Please refer to the testing code at function: testPQIterIndependentIterators",
+        "Please refer to the testing code at function: testPQIterUndefinedAfterChange",
+        "Please refer to the testing code at function: testPQInsertOwnedAndPopOwned",
+        "Please refer to the testing code at function: testPQPopReturnsElementsByPriority",
+        "Please refer to the testing code at function: testPQInlineStoresValuesAndGrows",
+        "Please refer to the testing code at function: testPQDeclareKeepsSameOrderAsGenericQueue",
+        "Please refer to the testing code at function: testPQInsertBulkMatchesSeparateInserts",
+        "Please refer to the testing code at function: testPQSnapshotSharesUntilChanged",
+        "Please refer to the testing code at function: testPQClearAndDestroyUseFreeBatch",
+        "Please refer to the testing code at function: testPQCapacityReserveAndShrink",
+        "Please refer to the testing code at function: testPQAllocatorAndPoolAreUsedForAllMemory",
+        "Please refer to the testing code at function: testConcurrentPQInsertAndPopFromManyThreads",
+        "Please refer to the testing code at function: testMultiQueuePopsEveryElementOnceAndMeasuresRankError",
+        "Please refer to the testing code at function: testPQBatchesMatchSeparateInsertsAndPops",
+        "Please refer to the testing code at function: testPQPeekTopKMatchesPopOrderWithoutChangingQueue",
+        "Please refer to the testing code at function: testPQDoubleEndedMatchesRegularQueueAtBothEnds",
+        "Please refer to the testing code at function: testPQBoundedRejectsOrEvictsLowestPriority",
+        "Please refer to the testing code at function: testRadixHeapPopsMonotoneKeysInOrder",
+        "Please refer to the testing code at function: testTimingWheelExpiresInOrderAndCancels",
+        "Please refer to the testing code at function: testPQArityQueuesMatchBinaryQueue",
+        "Please refer to the testing code at function: testPQPrimitivePrioritiesMatchCustomQueue",
+        "Please refer to the testing code at function: testPQMeldMovesElementsWithoutCopying",
+        "Please refer to the testing code at function: testPairingHeapMatchesPriorityQueueAndMelds",
+        "Please refer to the testing code at function: testPQClearOfSnapshotCopiesNothing"
 };
 
 int main() {
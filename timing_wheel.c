@@ -0,0 +1,302 @@
+#include "timing_wheel.h"
+#include "pq_pool.h"
+#include <assert.h>
+#include <stdlib.h>
+#include <stdbool.h>
+
+/*----------------------------------------------------------------------
+                         Implementation constants
+ ----------------------------------------------------------------------*/
+
+// every wheel has 2^SLOT_BITS slots, and LEVELS wheels cover all of the 64 bits of a time
+#define SLOT_BITS 6
+#define SLOTS (1 << SLOT_BITS)
+#define LEVELS 11
+
+// The number of timers allocated at once by the timer pool
+#define TIMERS_PER_SLAB 64
+
+// a timer, in the list of its slot
+struct TWTimer_t {
+    struct TWTimer_t* next;
+    struct TWTimer_t* previous;
+    PQElement element;
+    unsigned long long deadline;
+
+    //the wheel and slot whose list the timer is in
+    int level;
+    int slot;
+};
+
+// the timers of a slot, in insertion order
+typedef struct SlotStruct {
+    TWTimer first;
+    TWTimer last;
+} Slot;
+
+struct TimingWheel_t {
+    Slot slots[LEVELS][SLOTS];
+
+    //bit i of occupied[level] is set if slots[level][i] isn't empty
+    unsigned long long occupied[LEVELS];
+
+    //number of timers in the wheel
+    int size;
+
+    //the current time. every timer is in the wheel of the highest bits in which its deadline differs from it
+    //(the lowest wheel if the deadline is now, or was already reached)
+    unsigned long long now;
+
+    //the timers are allocated from a pool, so inserting one doesn't call malloc
+    PQPool timer_pool;
+
+    // function pointers that were defined in the header file
+    CopyPQElement copy_element;
+    FreePQElement free_element;
+};
+
+/*----------------------------------------------------------------------
+                        Static helper functions
+ ----------------------------------------------------------------------*/
+
+// returns the index of the lowest set bit of bits, which must not be 0
+static int lowestSetBit(unsigned long long bits) {
+    assert(bits != 0);
+    int bit = 0;
+    for(int shift = 32; shift > 0; shift /= 2) {
+        if((bits & ((1ULL << shift) - 1)) == 0) {
+            bits >>= shift;
+            bit += shift;
+        }
+    }
+    return bit;
+}
+
+// returns the index of the highest set bit of bits, which must not be 0
+static int highestSetBit(unsigned long long bits) {
+    assert(bits != 0);
+    int bit = 0;
+    for(int shift = 32; shift > 0; shift /= 2) {
+        if(bits >> shift) {
+            bits >>= shift;
+            bit += shift;
+        }
+    }
+    return bit;
+}
+
+// adds timer to the end of the list of its slot, by its deadline and the current time
+static void placeTimer(TimingWheel wheel, TWTimer timer) {
+    // a deadline that was already reached is placed as if it were now
+    unsigned long long deadline = timer->deadline > wheel->now ? timer->deadline : wheel->now;
+    unsigned long long difference = deadline ^ wheel->now;
+    int level = difference == 0 ? 0 : highestSetBit(difference) / SLOT_BITS;
+    int slot = (int)((deadline >> (level * SLOT_BITS)) & (SLOTS - 1));
+
+    Slot* target = &wheel->slots[level][slot];
+    timer->level = level;
+    timer->slot = slot;
+    timer->next = NULL;
+    timer->previous = target->last;
+    if(target->last != NULL) {
+        target->last->next = timer;
+    } else {
+        target->first = timer;
+    }
+    target->last = timer;
+    wheel->occupied[level] |= 1ULL << slot;
+}
+
+// takes timer out of the list of its slot
+static void unlinkTimer(TimingWheel wheel, TWTimer timer) {
+    Slot* slot = &wheel->slots[timer->level][timer->slot];
+    if(timer->previous != NULL) {
+        timer->previous->next = timer->next;
+    } else {
+        slot->first = timer->next;
+    }
+    if(timer->next != NULL) {
+        timer->next->previous = timer->previous;
+    } else {
+        slot->last = timer->previous;
+    }
+    if(slot->first == NULL) {
+        wheel->occupied[timer->level] &= ~(1ULL << timer->slot);
+    }
+}
+
+// takes all the timers out of a slot, and returns the first of them (still linked to each other)
+static TWTimer takeSlot(TimingWheel wheel, int level, int slot) {
+    TWTimer first = wheel->slots[level][slot].first;
+    wheel->slots[level][slot].first = NULL;
+    wheel->slots[level][slot].last = NULL;
+    wheel->occupied[level] &= ~(1ULL << slot);
+    return first;
+}
+
+// finds the earliest non empty slot, sets level and slot to it, and returns the time at which it begins.
+// the lowest wheel with timers has the earliest ones: every higher wheel only has timers past the current
+// slot of the wheel below it. returns false if the wheel is empty
+static bool nextSlot(const TimingWheel wheel, int* level, int* slot, unsigned long long* start) {
+    for(int current = 0; current < LEVELS; current++) {
+        if(wheel->occupied[current] == 0) {
+            continue;
+        }
+        *level = current;
+        *slot = lowestSetBit(wheel->occupied[current]);
+
+        // the time keeps its bits above the wheel, and the slot's bits in it, and starts its bits below it
+        int wheel_bits = (current + 1) * SLOT_BITS;
+        unsigned long long above = wheel_bits >= 64 ? 0 : (wheel->now >> wheel_bits) << wheel_bits;
+        *start = above | ((unsigned long long)*slot << (current * SLOT_BITS));
+        return true;
+    }
+    return false;
+}
+
+// frees the element of timer with the free function, and returns timer to the pool
+static void freeTimer(TimingWheel wheel, TWTimer timer) {
+    wheel->free_element(timer->element);
+    pqPoolFree(wheel->timer_pool, timer);
+}
+
+/*----------------------------------------------------------------------
+                        Timing wheel functions
+ ----------------------------------------------------------------------*/
+
+TimingWheel twCreate(CopyPQElement copy_element, FreePQElement free_element, unsigned long long start_time) {
+    // check for NULL parameters
+    if(copy_element == NULL || free_element == NULL) {
+        return NULL;
+    }
+
+    TimingWheel wheel = malloc(sizeof(*wheel));
+    if(wheel == NULL) {
+        return NULL;
+    }
+    wheel->timer_pool = pqPoolCreate(sizeof(struct TWTimer_t), TIMERS_PER_SLAB, NULL);
+    if(wheel->timer_pool == NULL) {
+        free(wheel);
+        return NULL;
+    }
+
+    for(int level = 0; level < LEVELS; level++) {
+        for(int slot = 0; slot < SLOTS; slot++) {
+            wheel->slots[level][slot].first = NULL;
+            wheel->slots[level][slot].last = NULL;
+        }
+        wheel->occupied[level] = 0;
+    }
+    wheel->size = 0;
+    wheel->now = start_time;
+
+    // use the funcs given by the user
+    wheel->copy_element = copy_element;
+    wheel->free_element = free_element;
+
+    return wheel;
+}
+
+void twDestroy(TimingWheel wheel) {
+    if(wheel == NULL) {
+        return;
+    }
+
+    // the timers themselves are freed with their pool
+    for(int level = 0; level < LEVELS; level++) {
+        for(int slot = 0; slot < SLOTS; slot++) {
+            for(TWTimer timer = wheel->slots[level][slot].first; timer != NULL; timer = timer->next) {
+                wheel->free_element(timer->element);
+            }
+        }
+    }
+    pqPoolDestroy(wheel->timer_pool);
+    free(wheel);
+}
+
+int twGetSize(TimingWheel wheel) {
+    if(wheel == NULL) {
+        return -1;
+    }
+    return wheel->size;
+}
+
+unsigned long long twGetTime(TimingWheel wheel) {
+    if(wheel == NULL) {
+        return 0;
+    }
+    return wheel->now;
+}
+
+PriorityQueueResult twInsert(TimingWheel wheel, PQElement element, unsigned long long deadline, TWTimer* timer) {
+    if(wheel == NULL || element == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    TWTimer new_timer = pqPoolAlloc(wheel->timer_pool);
+    if(new_timer == NULL) {
+        return PQ_OUT_OF_MEMORY;
+    }
+    new_timer->element = wheel->copy_element(element);
+    if(new_timer->element == NULL) {
+        pqPoolFree(wheel->timer_pool, new_timer);
+        return PQ_OUT_OF_MEMORY;
+    }
+    new_timer->deadline = deadline;
+    placeTimer(wheel, new_timer);
+    wheel->size++;
+
+    if(timer != NULL) {
+        *timer = new_timer;
+    }
+    return PQ_SUCCESS;
+}
+
+PriorityQueueResult twCancel(TimingWheel wheel, TWTimer timer, PQElement* element) {
+    if(wheel == NULL || timer == NULL) {
+        return PQ_NULL_ARGUMENT;
+    }
+
+    unlinkTimer(wheel, timer);
+    wheel->size--;
+
+    // the caller gets the element if it asked for it, and the rest is freed
+    if(element != NULL) {
+        *element = timer->element;
+        pqPoolFree(wheel->timer_pool, timer);
+    } else {
+        freeTimer(wheel, timer);
+    }
+    return PQ_SUCCESS;
+}
+
+int twAdvance(TimingWheel wheel, unsigned long long now, ExpireTWTimer expire, void* context) {
+    if(wheel == NULL || expire == NULL || now < wheel->now) {
+        return -1;
+    }
+
+    // moves to the earliest non empty slot until it is past now: a slot of the lowest wheel expires
+    // all of its timers together, and a slot of a higher wheel moves its timers to the lower wheels
+    int expired = 0;
+    int level, slot;
+    unsigned long long start;
+    while(nextSlot(wheel, &level, &slot, &start) && start <= now) {
+        wheel->now = start;
+        TWTimer timer = takeSlot(wheel, level, slot);
+        while(timer != NULL) {
+            TWTimer next = timer->next;
+            if(level == 0) {
+                wheel->size--;
+                expire(timer->element, timer->deadline, context);
+                freeTimer(wheel, timer);
+                expired++;
+            } else {
+                placeTimer(wheel, timer);
+            }
+            timer = next;
+        }
+    }
+    wheel->now = now;
+
+    return expired;
+}
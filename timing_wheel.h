@@ -0,0 +1,131 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include "priority_queue.h"
+
+/**
+* Hierarchical Timing Wheel Container
+*
+* Implements a timer queue: elements are inserted with a deadline (an unsigned integer time, in ticks),
+* and are expired once the wheel's time is advanced to their deadline. Unlike a priority queue used as
+* a timer queue, inserting and cancelling a timer take O(1) time, which suits timers that are mostly
+* cancelled before they expire (timeouts).
+* It uses the same element function types as the priority queue in priority_queue.h.
+*
+* The timers are kept in 11 wheels of 64 slots (Varghese and Lauck, "Hashed and Hierarchical Timing
+* Wheels"): a timer is put in the wheel of the highest 6 bits in which its deadline differs from the current
+* time, in the slot of its deadline's bits there. When the time reaches the slot of a higher wheel, its
+* timers are moved to the lower wheels, and the timers of a slot of the lowest wheel are expired together.
+* Advancing the time skips empty slots, so it takes time in the number of expired (or moved) timers,
+* not in the number of ticks.
+*
+* The following functions are available:
+*   twCreate		    - Creates a new empty timing wheel
+*   twDestroy		    - Deletes an existing timing wheel and frees all resources
+*   twGetSize		    - Returns the number of timers in a given timing wheel
+*   twGetTime		    - Returns the current time of a given timing wheel
+*   twInsert		    - Inserts an element with a given deadline, and returns a handle to cancel it with
+*   twCancel		    - Removes a timer before it expires, in O(1)
+*   twAdvance		    - Advances the time, expiring all the timers whose deadline was reached
+*/
+
+/** Type for defining the timing wheel */
+typedef struct TimingWheel_t *TimingWheel;
+
+/** Handle of a timer in a timing wheel, valid from its insertion until it expires or is cancelled */
+typedef struct TWTimer_t *TWTimer;
+
+/**
+* Type of function called for every expired timer, with its element and deadline, and the context that
+* was given to twAdvance. The element still belongs to the timing wheel, and is freed after the call.
+* The function may insert new timers into the wheel, but not cancel timers or advance it.
+*/
+typedef void(*ExpireTWTimer)(PQElement element, unsigned long long deadline, void* context);
+
+/**
+* twCreate: Allocates a new empty timing wheel.
+*
+* @param copy_element - Function pointer to be used for copying data elements into the timing wheel.
+* @param free_element - Function pointer to be used for removing data elements from the timing wheel.
+* @param start_time - The current time of the wheel.
+* @return
+* 	NULL - if one of the parameters is NULL or allocations failed.
+* 	A new timing wheel in case of success.
+*/
+TimingWheel twCreate(CopyPQElement copy_element, FreePQElement free_element, unsigned long long start_time);
+
+/**
+* twDestroy: Deallocates an existing timing wheel. Frees the elements of all of its timers by using
+* the free function.
+*
+* @param wheel - Target timing wheel to be deallocated. If it is NULL nothing will be done
+*/
+void twDestroy(TimingWheel wheel);
+
+/**
+* twGetSize: Returns the number of timers in a timing wheel (inserted, and not expired or cancelled yet).
+* @param wheel - The timing wheel which size is requested
+* @return
+* 	-1 if a NULL pointer was sent.
+* 	Otherwise the number of timers in the timing wheel.
+*/
+int twGetSize(TimingWheel wheel);
+
+/**
+* twGetTime: Returns the current time of a timing wheel (the start time, or the time it was last advanced to).
+* @param wheel - The timing wheel which time is requested
+* @return
+* 	0 if a NULL pointer was sent.
+* 	Otherwise the current time of the timing wheel.
+*/
+unsigned long long twGetTime(TimingWheel wheel);
+
+/**
+*   twInsert: add a specified element with a specific deadline, in O(1).
+*   A deadline that was already reached expires on the next twAdvance.
+*
+* @param wheel - The timing wheel for which to add the data element
+* @param element - The element which need to be added. A copy of the element will be inserted
+*      as supplied by the copying function which is given at initialization.
+* @param deadline - The time at which the timer expires.
+* @param timer - Set to the handle of the new timer, to cancel it with. Ignored if NULL.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as wheel or element
+* 	PQ_OUT_OF_MEMORY if an allocation failed (Meaning the function for copying
+* 	an element failed)
+* 	PQ_SUCCESS the timer had been inserted successfully
+*/
+PriorityQueueResult twInsert(TimingWheel wheel, PQElement element, unsigned long long deadline, TWTimer* timer);
+
+/**
+*   twCancel: Removes a timer from the timing wheel before it expires, in O(1), and hands its element to
+*   the caller. The handle is invalid after this operation.
+*
+* @param wheel - The timing wheel that the timer was inserted into.
+* @param timer - The handle of the timer, as returned by twInsert. Must not have expired or been cancelled.
+* @param element - Set to the element of the timer, which the caller is responsible for freeing.
+* 		If NULL, the element is freed using the free function given at initialization.
+* @return
+* 	PQ_NULL_ARGUMENT if a NULL was sent as wheel or timer.
+* 	PQ_SUCCESS the timer had been removed successfully.
+*/
+PriorityQueueResult twCancel(TimingWheel wheel, TWTimer timer, PQElement* element);
+
+/**
+*   twAdvance: Advances the time of the timing wheel to now, and expires all the timers whose deadline was
+*   reached, in the order of their deadlines (and of insertion, for equal deadlines). A timer that was inserted
+*   with a deadline that was already reached expires with the timers of the time it was inserted at.
+*   expire is called for every expired timer, and then its element is freed. The handles of the expired timers
+*   are invalid after this operation.
+*
+* @param wheel - The timing wheel to advance.
+* @param now - The new time of the timing wheel. Must not be before its current time.
+* @param expire - The function to call for every expired timer.
+* @param context - Passed to every call of expire.
+* @return
+* 	-1 if a NULL was sent as wheel or expire, or now is before the current time of the wheel.
+* 	Otherwise the number of expired timers.
+*/
+int twAdvance(TimingWheel wheel, unsigned long long now, ExpireTWTimer expire, void* context);
+
+#endif /* TIMING_WHEEL_H */